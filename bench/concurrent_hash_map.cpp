@@ -0,0 +1,72 @@
+// 95% contains / 5% insert_or_assign over 100K uint64 keys, 2M operations
+// split across 1 to 64 threads, in ns per operation. concurrent_hash_map
+// against a single mutex around std::unordered_map.
+//
+//   g++ -std=c++17 -O2 -pthread -I include bench/concurrent_hash_map.cpp -o concurrent_hash_map
+
+#include <lzt/concurrent_hash_map.h>
+#include <unordered_map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdio>
+#include <cstdint>
+
+using clk = std::chrono::steady_clock;
+
+class locked_map {
+public:
+	bool contains(uint64_t key) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _map.find(key) != _map.end();
+	}
+
+	void insert_or_assign(uint64_t key, uint64_t value) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		_map[key] = value;
+	}
+private:
+	std::mutex _mutex;
+	std::unordered_map<uint64_t, uint64_t> _map;
+};
+
+template<typename Map>
+static double run(Map& map, unsigned threadCount) {
+	constexpr size_t operations = 2000000;
+	constexpr uint64_t keyCount = 100000;
+
+	std::vector<std::thread> threads;
+	const clk::time_point start = clk::now();
+	for (unsigned t = 0; t < threadCount; ++t) {
+		threads.emplace_back([&map, t, threadCount] {
+			std::mt19937_64 rng(t);
+			for (size_t i = 0; i < operations / threadCount; ++i) {
+				const uint64_t x = rng();
+				if (x % 100 < 95)
+					(void)map.contains(x % keyCount);
+				else
+					map.insert_or_assign(x % keyCount, x);
+			}
+		});
+	}
+	for (std::thread& thread : threads)
+		thread.join();
+	return std::chrono::duration<double, std::nano>(clk::now() - start).count() / operations;
+}
+
+int main() {
+	lzt::concurrent_hash_map<uint64_t, uint64_t> sharded;
+	locked_map locked;
+	for (uint64_t i = 0; i < 100000; ++i) {
+		sharded.insert_or_assign(i, i);
+		locked.insert_or_assign(i, i);
+	}
+
+	std::printf("%u hardware threads\n", std::thread::hardware_concurrency());
+	for (const unsigned threads : { 1u, 2u, 4u, 8u, 16u, 64u }) {
+		std::printf("threads %2u  concurrent_hash_map %6.1f ns/op  mutex + unordered_map %6.1f ns/op\n",
+			threads, run(sharded, threads), run(locked, threads));
+	}
+}
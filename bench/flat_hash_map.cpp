@@ -0,0 +1,71 @@
+// uint64 -> uint64 map with random keys: insert, successful find,
+// unsuccessful find and erase, in ns per operation, for 1K to 10M
+// elements. lzt::flat_hash_map against std::unordered_map.
+//
+//   g++ -std=c++17 -O2 -I include bench/flat_hash_map.cpp -o flat_hash_map
+
+#include <lzt/flat_hash_map.h>
+#include <unordered_map>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdio>
+#include <cstdint>
+
+using clk = std::chrono::steady_clock;
+
+static volatile uint64_t sink;
+
+static double ns_since(clk::time_point start, size_t count) {
+	return std::chrono::duration<double, std::nano>(clk::now() - start).count() / count;
+}
+
+template<typename Map>
+static void run(const char* name, const std::vector<uint64_t>& keys, const std::vector<uint64_t>& missing) {
+	const size_t n = keys.size();
+	Map map;
+
+	clk::time_point start = clk::now();
+	for (size_t i = 0; i < n; ++i)
+		map.emplace(keys[i], i);
+	const double insert = ns_since(start, n);
+
+	start = clk::now();
+	uint64_t sum = 0;
+	for (size_t i = 0; i < n; ++i)
+		sum += map.find(keys[(i * 7919) % n])->second;
+	const double hit = ns_since(start, n);
+	sink = sum;
+
+	start = clk::now();
+	sum = 0;
+	for (size_t i = 0; i < n; ++i)
+		sum += map.find(missing[i]) != map.end();
+	const double miss = ns_since(start, n);
+	sink = sum;
+
+	start = clk::now();
+	for (size_t i = 0; i < n; ++i)
+		map.erase(keys[i]);
+	const double erase = ns_since(start, n);
+
+	std::printf("%-20s n=%-9zu insert %7.1f  hit %6.1f  miss %6.1f  erase %6.1f ns\n", name, n, insert, hit, miss, erase);
+}
+
+int main() {
+	for (const size_t n : { size_t(1000), size_t(100000), size_t(1000000), size_t(10000000) }) {
+		// Odd keys are inserted and even keys are looked up as misses.
+		std::mt19937_64 rng(n);
+		std::vector<uint64_t> keys(n), missing(n);
+		for (uint64_t& key : keys)
+			key = rng() | 1;
+		for (uint64_t& key : missing)
+			key = rng() & ~uint64_t(1);
+
+		const int rounds = n <= 100000 ? 3 : 1;
+		for (int round = 0; round < rounds; ++round) {
+			run<lzt::flat_hash_map<uint64_t, uint64_t>>("lzt::flat_hash_map", keys, missing);
+			run<std::unordered_map<uint64_t, uint64_t>>("std::unordered_map", keys, missing);
+		}
+	}
+}
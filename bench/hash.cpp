@@ -0,0 +1,47 @@
+// Hash throughput in GB/s for 8 B to 1 MB keys: std::hash<lzt::string>
+// against std::hash<std::string> and a per-character FNV-1a loop. The
+// key is read through a volatile pointer so the hash is not hoisted out
+// of the loop.
+//
+//   g++ -std=c++17 -O2 -I include bench/hash.cpp -o hash
+
+#include <lzt/string.h>
+#include <lzt/hash.h>
+#include <string>
+#include <chrono>
+#include <cstdio>
+
+using clk = std::chrono::steady_clock;
+
+template<typename Key, typename Hash>
+static double gbps(const Key& key, size_t length, size_t iterations, Hash hash) {
+	const Key* volatile source = &key;
+	volatile size_t sink = 0;
+	const clk::time_point start = clk::now();
+	for (size_t i = 0; i < iterations; ++i)
+		sink = sink + hash(*source);
+	const double seconds = std::chrono::duration<double>(clk::now() - start).count();
+	return double(length) * double(iterations) / seconds / 1e9;
+}
+
+static size_t fnv1a(const std::string& key) noexcept {
+	size_t hash = 1469598103934665603ull;
+	for (const char c : key)
+		hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+	return hash;
+}
+
+int main() {
+	for (const size_t length : { size_t(8), size_t(64), size_t(1024), size_t(1) << 20 }) {
+		std::string key(length, '\0');
+		for (size_t i = 0; i < length; ++i)
+			key[i] = static_cast<char>(i * 31 + 7);
+		const lzt::string lkey(key.data(), key.size());
+		const size_t iterations = (size_t(1) << 31) / (length + 16);
+
+		std::printf("%8zu B  lzt %6.2f GB/s  std::hash<std::string> %6.2f GB/s  FNV-1a %6.2f GB/s\n", length,
+			gbps(lkey, length, iterations, std::hash<lzt::string>()),
+			gbps(key, length, iterations, std::hash<std::string>()),
+			gbps(key, length, iterations, fnv1a));
+	}
+}
@@ -0,0 +1,80 @@
+// 256 MB allocate + memset with make_unique against
+// make_unique_for_overwrite, then a 512 MB array of doubles from
+// make_unique_aligned_for_overwrite against make_unique_huge: first-touch
+// fill time and 20M random reads. Needs about 1 GB of free memory. The
+// first round also pays for the kernel handing out fresh memory; the
+// later rounds are the warm figures.
+//
+//   g++ -std=c++17 -O2 -I include bench/huge_page.cpp -o huge_page
+
+#include <lzt/memory/make_unique.h>
+#include <lzt/memory/huge_page.h>
+#include <chrono>
+#include <random>
+#include <cstdio>
+#include <cstring>
+
+using clk = std::chrono::steady_clock;
+
+static volatile double sink;
+
+template<typename F>
+static double ms(F f) {
+	const clk::time_point start = clk::now();
+	f();
+	return std::chrono::duration<double, std::milli>(clk::now() - start).count();
+}
+
+template<typename Ptr>
+static double fill(Ptr& data, size_t count) {
+	return ms([&] {
+		for (size_t i = 0; i < count; ++i)
+			data[i] = static_cast<double>(i);
+	});
+}
+
+// count must be a power of two.
+template<typename Ptr>
+static double gather(const Ptr& data, size_t count) {
+	return ms([&] {
+		std::mt19937_64 rng(1);
+		double sum = 0;
+		for (int i = 0; i < 20000000; ++i)
+			sum += data[rng() & (count - 1)];
+		sink = sum;
+	});
+}
+
+int main() {
+	constexpr size_t bytes = size_t(256) << 20;
+	for (int round = 0; round < 2; ++round) {
+		const double valueInit = ms([&] {
+			auto data = lzt::make_unique<char[]>(bytes);
+			std::memset(data.get(), 1, bytes);
+			sink = data[bytes / 3];
+		});
+		const double overwrite = ms([&] {
+			auto data = lzt::make_unique_for_overwrite<char[]>(bytes);
+			std::memset(data.get(), 1, bytes);
+			sink = data[bytes / 3];
+		});
+		std::printf("256 MB alloc + memset: make_unique %6.1f ms  make_unique_for_overwrite %6.1f ms\n", valueInit, overwrite);
+	}
+
+	constexpr size_t count = size_t(64) << 20;
+	for (int round = 0; round < 3; ++round) {
+		double alignedFill, alignedGather, hugeFill, hugeGather;
+		{
+			auto data = lzt::make_unique_aligned_for_overwrite<double[]>(count, 64);
+			alignedFill = fill(data, count);
+			alignedGather = gather(data, count);
+		}
+		{
+			auto data = lzt::make_unique_huge<double[]>(count);
+			hugeFill = fill(data, count);
+			hugeGather = gather(data, count);
+		}
+		std::printf("512 MB of doubles: fill aligned %5.0f ms  huge %5.0f ms | 20M random reads aligned %5.0f ms  huge %5.0f ms\n",
+			alignedFill, hugeFill, alignedGather, hugeGather);
+	}
+}
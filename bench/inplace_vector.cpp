@@ -0,0 +1,64 @@
+// Builds a list of n ints with push_back, sums it and destroys it, 2M
+// times, for n up to the inline capacity. ns and heap allocations per
+// list: lzt::vector, std::vector, small_vector<int, 16> and
+// inplace_vector<int, 16>.
+//
+//   g++ -std=c++17 -O2 -I include bench/inplace_vector.cpp -o inplace_vector
+
+#include <lzt/small_vector.h>
+#include <lzt/inplace_vector.h>
+#include <lzt/vector.h>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+	++allocations;
+	if (void* ptr = std::malloc(size))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+	std::free(ptr);
+}
+
+using clk = std::chrono::steady_clock;
+
+template<typename Vector>
+static void run(const char* name, int n) {
+	constexpr int lists = 2000000;
+	volatile long sink = 0;
+
+	allocations = 0;
+	const clk::time_point start = clk::now();
+	for (int list = 0; list < lists; ++list) {
+		Vector v;
+		for (int i = 0; i < n; ++i)
+			v.push_back(i + list);
+
+		long sum = 0;
+		for (const int x : v)
+			sum += x;
+		sink = sink + sum;
+	}
+	const double ns = std::chrono::duration<double, std::nano>(clk::now() - start).count() / lists;
+	std::printf("%-24s n=%-2d %7.1f ns/list  %.2f allocations/list\n", name, n, ns, double(allocations) / lists);
+}
+
+int main() {
+	for (const int n : { 2, 6, 8, 16 }) {
+		run<lzt::vector<int>>("lzt::vector", n);
+		run<std::vector<int>>("std::vector", n);
+		run<lzt::small_vector<int, 16>>("small_vector<int, 16>", n);
+		run<lzt::inplace_vector<int, 16>>("inplace_vector<int, 16>", n);
+	}
+}
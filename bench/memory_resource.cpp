@@ -0,0 +1,79 @@
+// One simulated request builds 24 header strings, a 48-entry
+// flat_hash_map and 16 200-byte strings, then tears them down. Time per
+// request with std::allocator, a monotonic arena released after each
+// request, an unsynchronized pool and polymorphic_allocator over
+// new_delete_resource().
+//
+//   g++ -std=c++17 -O2 -I include bench/memory_resource.cpp -o memory_resource
+
+#include <lzt/memory/monotonic_buffer_resource.h>
+#include <lzt/memory/pool_resource.h>
+#include <lzt/memory/polymorphic_allocator.h>
+#include <lzt/flat_hash_map.h>
+#include <lzt/vector.h>
+#include <lzt/string.h>
+#include <memory>
+#include <chrono>
+#include <cstdio>
+
+using namespace lzt::memory;
+using clk = std::chrono::steady_clock;
+
+struct std_types {
+	using string = lzt::basic_string<char, std::char_traits<char>, std::allocator<char>>;
+	using vector = lzt::vector<string>;
+	using map = lzt::flat_hash_map<int, int>;
+};
+
+struct pmr_types {
+	using string = lzt::basic_string<char, std::char_traits<char>, polymorphic_allocator<char>>;
+	using vector = lzt::vector<string, polymorphic_allocator<string>>;
+	using map = lzt::flat_hash_map<int, int, lzt::hash<int>, lzt::equal_to<int>,
+		polymorphic_allocator<std::pair<const int, int>>>;
+};
+
+template<typename Types, typename Alloc, typename Reset>
+static double us_per_request(int requests, const Alloc& alloc, Reset reset) {
+	using string = typename Types::string;
+	volatile size_t sink = 0;
+
+	const clk::time_point start = clk::now();
+	for (int r = 0; r < requests; ++r) {
+		{
+			typename Types::vector headers(alloc);
+			for (int i = 0; i < 24; ++i) {
+				string header("x-request-header-name-number-", alloc);
+				header += static_cast<char>('a' + i % 26);
+				headers.push_back(header);
+			}
+
+			typename Types::map params(0, lzt::hash<int>(), lzt::equal_to<int>(), alloc);
+			for (int i = 0; i < 48; ++i)
+				params[i * 7 + r] = i;
+
+			typename Types::vector body(alloc);
+			for (int i = 0; i < 16; ++i)
+				body.emplace_back(string(200, 'b', alloc));
+
+			sink = sink + headers.size() + params.size() + body.size();
+		}
+		reset();
+	}
+	return std::chrono::duration<double, std::micro>(clk::now() - start).count() / requests;
+}
+
+int main() {
+	constexpr int requests = 200000;
+	alignas(16) static unsigned char buffer[64 * 1024];
+	monotonic_buffer_resource arena(buffer, sizeof(buffer));
+	unsynchronized_pool_resource pool;
+
+	for (int round = 0; round < 3; ++round) {
+		const double plain = us_per_request<std_types>(requests, std::allocator<char>(), [] {});
+		const double monotonic = us_per_request<pmr_types>(requests, polymorphic_allocator<char>(&arena), [&] { arena.release(); });
+		const double pooled = us_per_request<pmr_types>(requests, polymorphic_allocator<char>(&pool), [] {});
+		const double newDelete = us_per_request<pmr_types>(requests, polymorphic_allocator<char>(new_delete_resource()), [] {});
+		std::printf("us/request: std::allocator %.2f  monotonic + release() %.2f  unsynchronized_pool %.2f  pmr new_delete %.2f\n",
+			plain, monotonic, pooled, newDelete);
+	}
+}
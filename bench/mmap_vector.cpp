@@ -0,0 +1,76 @@
+// Builds 20M 16-byte records (320 MB) in an mmap_vector and in an
+// lzt::vector, then compares three ways of getting at the saved file:
+// read(2) into an lzt::vector, a read-only mmap_vector open plus one
+// lookup, and an open plus a full sequential scan. POSIX only. The file
+// is written to the path given as the first argument (mmap_vector.dat
+// by default) and removed afterwards.
+//
+//   g++ -std=c++17 -O2 -I include bench/mmap_vector.cpp -o mmap_vector
+
+#include <lzt/mmap_vector.h>
+#include <lzt/vector.h>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+using clk = std::chrono::steady_clock;
+
+struct record {
+	long id;
+	double score;
+};
+
+static volatile double sink;
+
+template<typename F>
+static double ms(F f) {
+	const clk::time_point start = clk::now();
+	f();
+	return std::chrono::duration<double, std::milli>(clk::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+	const char* path = argc > 1 ? argv[1] : "mmap_vector.dat";
+	constexpr size_t count = 20000000;
+
+	const double buildMapped = ms([&] {
+		lzt::mmap_vector<record> v(path, lzt::mmap_mode::truncate);
+		for (size_t i = 0; i < count; ++i)
+			v.push_back({ long(i), i * 0.5 });
+	});
+	const double buildHeap = ms([&] {
+		lzt::vector<record> v;
+		for (size_t i = 0; i < count; ++i)
+			v.push_back({ long(i), i * 0.5 });
+		sink = v.back().score;
+	});
+	std::printf("build 20M records: lzt::vector %.0f ms  mmap_vector %.0f ms\n", buildHeap, buildMapped);
+
+	for (int round = 0; round < 3; ++round) {
+		const double load = ms([&] {
+			lzt::vector<record> v;
+			v.resize_for_overwrite(count);
+			const int fd = ::open(path, O_RDONLY);
+			if (::read(fd, v.data(), count * sizeof(record)) != static_cast<ssize_t>(count * sizeof(record)))
+				std::puts("short read");
+			::close(fd);
+			sink = v[count / 2].score;
+		});
+		const double lookup = ms([&] {
+			lzt::mmap_vector<record> v(path, lzt::mmap_mode::read_only);
+			sink = v[count / 2].score;
+		});
+		const double scan = ms([&] {
+			lzt::mmap_vector<record> v(path, lzt::mmap_mode::read_only);
+			v.advise(lzt::mmap_advice::sequential);
+			double sum = 0;
+			for (const record& r : v)
+				sum += r.score;
+			sink = sum;
+		});
+		std::printf("read() into lzt::vector %6.1f ms | mmap_vector open + 1 lookup %6.3f ms | open + full scan %6.1f ms\n",
+			load, lookup, scan);
+	}
+	std::remove(path);
+}
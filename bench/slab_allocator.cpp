@@ -0,0 +1,189 @@
+// Per-operation allocation latency, operator new/delete against
+// slab_allocate/slab_deallocate.
+//
+// churn: each thread frees and reallocates random slots of a 4096-slot
+// working set with sizes of 16..2047 bytes, timing each free + allocate.
+// handoff: 4 producers allocate and pass the blocks to one consumer that
+// frees them, so every free is cross-thread.
+//
+//   g++ -std=c++17 -O2 -pthread -I include bench/slab_allocator.cpp -o slab_allocator
+
+#include <lzt/memory/slab_allocator.h>
+#include <new>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdio>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+using clk = std::chrono::steady_clock;
+
+struct histogram {
+	std::vector<uint64_t> samples;
+
+	void add(clk::time_point start) {
+		samples.push_back(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clk::now() - start).count()));
+	}
+
+	void merge(const histogram& other) {
+		samples.insert(samples.end(), other.samples.begin(), other.samples.end());
+	}
+
+	void print(const char* name, double nsPerOp) {
+		std::sort(samples.begin(), samples.end());
+		const auto at = [this](double q) {
+			return static_cast<unsigned long long>(samples[std::min(samples.size() - 1, static_cast<size_t>(q * samples.size()))]);
+		};
+		std::printf("%-26s %7.1f ns/op  p50 %5llu  p99 %6llu  p99.9 %7llu  max %8llu\n",
+			name, nsPerOp, at(0.5), at(0.99), at(0.999), at(1.0));
+	}
+};
+
+struct system_heap {
+	static void* allocate(size_t size) {
+		return ::operator new(size);
+	}
+
+	static void deallocate(void* ptr, size_t size) noexcept {
+		::operator delete(ptr, size);
+	}
+};
+
+struct slab_heap {
+	static void* allocate(size_t size) {
+		return lzt::memory::slab_allocate(size);
+	}
+
+	static void deallocate(void* ptr, size_t size) noexcept {
+		lzt::memory::slab_deallocate(ptr, size);
+	}
+};
+
+using block = std::pair<void*, size_t>;
+
+template<typename Heap>
+static void churn(const char* name, int threadCount) {
+	constexpr int operations = 400000;
+	const int perThread = operations / threadCount;
+	std::vector<histogram> histograms(threadCount);
+
+	const clk::time_point start = clk::now();
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadCount; ++t) {
+		threads.emplace_back([&, t] {
+			std::mt19937 rng(t);
+			std::vector<block> live(4096, block(nullptr, 0));
+			histogram& h = histograms[t];
+			h.samples.reserve(perThread);
+			for (int i = 0; i < perThread; ++i) {
+				block& slot = live[rng() & 4095];
+				size_t size = size_t(16) << (rng() % 7);
+				size += rng() % size;
+
+				const clk::time_point opStart = clk::now();
+				if (slot.first)
+					Heap::deallocate(slot.first, slot.second);
+				slot = block(Heap::allocate(size), size);
+				h.add(opStart);
+				static_cast<char*>(slot.first)[0] = 1;
+			}
+			for (const block& b : live) {
+				if (b.first)
+					Heap::deallocate(b.first, b.second);
+			}
+		});
+	}
+	for (std::thread& thread : threads)
+		thread.join();
+	const double nsPerOp = std::chrono::duration<double, std::nano>(clk::now() - start).count() / (perThread * threadCount);
+
+	histogram all;
+	for (const histogram& h : histograms)
+		all.merge(h);
+	char label[64];
+	std::snprintf(label, sizeof(label), "%s churn x%d", name, threadCount);
+	all.print(label, nsPerOp);
+}
+
+template<typename Heap>
+static void handoff(const char* name) {
+	constexpr int producers = 4;
+	constexpr int perProducer = 50000;
+
+	std::mutex mutex;
+	std::vector<block> queue;
+	int finished = 0;
+	histogram frees;
+	std::vector<histogram> allocations(producers);
+
+	const clk::time_point start = clk::now();
+	std::thread consumer([&] {
+		std::vector<block> local;
+		for (;;) {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				local.swap(queue);
+				if (local.empty() && finished == producers)
+					break;
+			}
+			for (const block& b : local) {
+				const clk::time_point opStart = clk::now();
+				Heap::deallocate(b.first, b.second);
+				frees.add(opStart);
+			}
+			local.clear();
+			std::this_thread::yield();
+		}
+	});
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < producers; ++t) {
+		threads.emplace_back([&, t] {
+			std::mt19937 rng(t);
+			std::vector<block> batch;
+			for (int i = 0; i < perProducer; ++i) {
+				const size_t size = size_t(16) << (rng() % 6);
+				const clk::time_point opStart = clk::now();
+				void* ptr = Heap::allocate(size);
+				allocations[t].add(opStart);
+				static_cast<char*>(ptr)[0] = 1;
+
+				batch.emplace_back(ptr, size);
+				if (batch.size() == 256) {
+					std::lock_guard<std::mutex> lock(mutex);
+					queue.insert(queue.end(), batch.begin(), batch.end());
+					batch.clear();
+				}
+			}
+			std::lock_guard<std::mutex> lock(mutex);
+			queue.insert(queue.end(), batch.begin(), batch.end());
+			++finished;
+		});
+	}
+	for (std::thread& thread : threads)
+		thread.join();
+	consumer.join();
+	const double nsPerOp = std::chrono::duration<double, std::nano>(clk::now() - start).count() / (perProducer * producers);
+
+	histogram all;
+	for (const histogram& h : allocations)
+		all.merge(h);
+	char label[64];
+	std::snprintf(label, sizeof(label), "%s handoff alloc", name);
+	all.print(label, nsPerOp);
+	std::snprintf(label, sizeof(label), "%s handoff free", name);
+	frees.print(label, nsPerOp);
+}
+
+int main() {
+	for (const int threads : { 1, 4, 16 }) {
+		churn<system_heap>("malloc", threads);
+		churn<slab_heap>("slab", threads);
+	}
+	handoff<system_heap>("malloc");
+	handoff<slab_heap>("slab");
+}
@@ -0,0 +1,49 @@
+// Appends 8-byte chunks to an empty string 5M times and pushes back 40M
+// single characters, lzt::string against std::string.
+//
+//   g++ -std=c++17 -O2 -I include bench/string_append.cpp -o string_append
+
+#include <lzt/string.h>
+#include <string>
+#include <chrono>
+#include <cstdio>
+
+using clk = std::chrono::steady_clock;
+
+template<typename F>
+static double ms(F f) {
+	const clk::time_point start = clk::now();
+	f();
+	return std::chrono::duration<double, std::milli>(clk::now() - start).count();
+}
+
+template<typename String>
+static double append_chunks(size_t count) {
+	volatile size_t sink = 0;
+	return ms([&] {
+		String s;
+		for (size_t i = 0; i < count; ++i)
+			s += "chunk-8b";
+		sink = s.size();
+	});
+}
+
+template<typename String>
+static double push_back_chars(size_t count) {
+	volatile size_t sink = 0;
+	return ms([&] {
+		String s;
+		for (size_t i = 0; i < count; ++i)
+			s.push_back(static_cast<char>('a' + i % 26));
+		sink = s.size();
+	});
+}
+
+int main() {
+	for (int round = 0; round < 3; ++round) {
+		std::printf("5M x 8-byte append: lzt::string %6.1f ms  std::string %6.1f ms | ",
+			append_chunks<lzt::string>(5000000), append_chunks<std::string>(5000000));
+		std::printf("40M push_back: lzt::string %6.1f ms  std::string %6.1f ms\n",
+			push_back_chars<lzt::string>(40000000), push_back_chars<std::string>(40000000));
+	}
+}
@@ -0,0 +1,62 @@
+// Per-operation cost of constructing, appending, inserting at the front,
+// erasing from the front, copying out and fill-constructing lzt::string
+// at 16 B, 1 KB and 1 MB.
+//
+//   g++ -std=c++17 -O2 -I include bench/string_bulk_copy.cpp -o string_bulk_copy
+
+#include <lzt/string.h>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+
+using clk = std::chrono::steady_clock;
+
+static volatile char sink;
+
+template<typename F>
+static double ns(size_t iterations, F f) {
+	const clk::time_point start = clk::now();
+	for (size_t i = 0; i < iterations; ++i)
+		f();
+	return std::chrono::duration<double, std::nano>(clk::now() - start).count() / iterations;
+}
+
+int main() {
+	for (const size_t size : { size_t(16), size_t(1024), size_t(1) << 20 }) {
+		const std::vector<char> source(size, 'x');
+		const lzt::string base(source.data(), size);
+		std::vector<char> target(size);
+		const size_t iterations = size < 2048 ? 2000000 : 300;
+
+		const double ctor = ns(iterations, [&] {
+			lzt::string s(source.data(), size);
+			sink = s[size / 2];
+		});
+		const double append = ns(iterations, [&] {
+			lzt::string s;
+			s.append(source.data(), size);
+			s.append(source.data(), size);
+			sink = s[size];
+		});
+		const double insert = ns(iterations, [&] {
+			lzt::string s(base);
+			s.insert(0, "abc", 3);
+			sink = s[size / 2];
+		});
+		const double erase = ns(iterations, [&] {
+			lzt::string s(base);
+			s.erase(0, 1);
+			sink = s[size / 2];
+		});
+		const double copy = ns(iterations, [&] {
+			base.copy(target.data(), size);
+			sink = target[size / 2];
+		});
+		const double fill = ns(iterations, [&] {
+			lzt::string s(size, 'y');
+			sink = s[size / 2];
+		});
+		std::printf("%8zu B  ctor %9.1f  append x2 %9.1f  insert@0 %9.1f  erase@0 %9.1f  copy %9.1f  fill %9.1f ns\n",
+			size, ctor, append, insert, erase, copy, fill);
+	}
+}
@@ -0,0 +1,47 @@
+// Substring search in a 16 KiB pseudo-random text, 20k searches per
+// needle: a 14-char needle whose first character never occurs and a
+// 45-char needle whose first character is common. Compared with
+// std::string::find and, where available, memmem.
+//
+//   g++ -std=c++17 -O2 -I include bench/string_find.cpp -o string_find
+
+#include <lzt/string.h>
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+using clk = std::chrono::steady_clock;
+
+template<typename F>
+static double ms(F find) {
+	volatile size_t sink = 0;
+	const clk::time_point start = clk::now();
+	for (int i = 0; i < 20000; ++i)
+		sink = sink + find();
+	return std::chrono::duration<double, std::milli>(clk::now() - start).count();
+}
+
+int main() {
+	static const char alphabet[] = " etaoinshrdlucmfwypvbgkqjxz,.\n";
+	std::string text;
+	unsigned state = 1;
+	for (int i = 0; i < 16384; ++i) {
+		state = state * 1103515245 + 12345;
+		text += alphabet[(state >> 16) % 30];
+	}
+	const lzt::string ltext(text.c_str(), text.size());
+
+	const std::string needles[] = { "Content-Length", "the quick brown fox jumps over the lazy dog!!" };
+	for (const std::string& needle : needles) {
+		std::printf("m=%-2zu lzt %6.1f ms  std %6.1f ms", needle.size(),
+			ms([&] { return ltext.find(needle.c_str()); }),
+			ms([&] { return text.find(needle); }));
+#if defined(__unix__) || defined(__APPLE__)
+		std::printf("  memmem %6.1f ms", ms([&] {
+			return static_cast<size_t>(memmem(text.data(), text.size(), needle.data(), needle.size()) != nullptr);
+		}));
+#endif
+		std::printf("\n");
+	}
+}
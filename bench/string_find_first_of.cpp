@@ -0,0 +1,35 @@
+// find_first_of / find_first_not_of over a 1 MiB haystack with no match,
+// 200 scans each, lzt::string against std::string. Build with
+// -DLZT_DISABLE_SIMD to time the bitmap fallback instead of the SIMD
+// kernels.
+//
+//   g++ -std=c++17 -O2 -I include bench/string_find_first_of.cpp -o string_find_first_of
+
+#include <lzt/string.h>
+#include <string>
+#include <chrono>
+#include <cstdio>
+
+using clk = std::chrono::steady_clock;
+
+template<typename String>
+static double scan(const String& s, const char* set, bool notOf) {
+	volatile size_t sink = 0;
+	const clk::time_point start = clk::now();
+	for (int i = 0; i < 200; ++i)
+		sink = sink + (notOf ? s.find_first_not_of(set) : s.find_first_of(set));
+	return std::chrono::duration<double, std::milli>(clk::now() - start).count();
+}
+
+int main() {
+	const std::string text(1 << 20, 'x');
+	const lzt::string ltext(text.data(), text.size());
+	const char* delimiters = " \t\n,;:";
+
+	for (int round = 0; round < 3; ++round) {
+		std::printf("find_first_of     lzt %6.1f ms  std %6.1f ms\n",
+			scan(ltext, delimiters, false), scan(text, delimiters, false));
+		std::printf("find_first_not_of lzt %6.1f ms  std %6.1f ms\n",
+			scan(ltext, "xyz", true), scan(text, "xyz", true));
+	}
+}
@@ -0,0 +1,61 @@
+// Reads a generated 2M-line text file word by word with operator>> and
+// line by line with getline, lzt::string against std::string. The file
+// is written to the path given as the first argument (string_io.txt by
+// default) and removed afterwards.
+//
+//   g++ -std=c++17 -O2 -I include bench/string_io.cpp -o string_io
+
+#include <lzt/string.h>
+#include <string>
+#include <fstream>
+#include <chrono>
+#include <cstdio>
+
+using clk = std::chrono::steady_clock;
+
+template<typename F>
+static double ms(F f) {
+	const clk::time_point start = clk::now();
+	f();
+	return std::chrono::duration<double, std::milli>(clk::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+	const char* path = argc > 1 ? argv[1] : "string_io.txt";
+	{
+		std::ofstream out(path);
+		for (int i = 0; i < 2000000; ++i)
+			out << "field" << i << " value-" << i * 7 << " some more words here to fill the line\n";
+	}
+
+	volatile size_t sink = 0;
+	for (int round = 0; round < 3; ++round) {
+		const double words = ms([&] {
+			std::ifstream in(path);
+			lzt::string word;
+			while (in >> word)
+				sink = sink + word.size();
+		});
+		const double stdWords = ms([&] {
+			std::ifstream in(path);
+			std::string word;
+			while (in >> word)
+				sink = sink + word.size();
+		});
+		const double lines = ms([&] {
+			std::ifstream in(path);
+			lzt::string line;
+			while (lzt::getline(in, line))
+				sink = sink + line.size();
+		});
+		const double stdLines = ms([&] {
+			std::ifstream in(path);
+			std::string line;
+			while (std::getline(in, line))
+				sink = sink + line.size();
+		});
+		std::printf("operator>> lzt %6.0f ms  std %6.0f ms | getline lzt %6.0f ms  std %6.0f ms\n",
+			words, stdWords, lines, stdLines);
+	}
+	std::remove(path);
+}
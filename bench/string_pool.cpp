@@ -0,0 +1,79 @@
+// Interns 2M metric names drawn from 20K distinct values and compares
+// neighbours: a vector of lzt::string against a string_pool and a vector
+// of atoms. Heap usage is reported on glibc only (mallinfo2).
+//
+//   g++ -std=c++17 -O2 -I include bench/string_pool.cpp -o string_pool
+
+#include <lzt/string_pool.h>
+#include <lzt/string.h>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <cstdio>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+using clk = std::chrono::steady_clock;
+
+template<typename F>
+static double ms(F f) {
+	const clk::time_point start = clk::now();
+	f();
+	return std::chrono::duration<double, std::milli>(clk::now() - start).count();
+}
+
+static double heap_mb() {
+#if defined(__GLIBC__)
+	const struct mallinfo2 info = mallinfo2();
+	return (info.uordblks + info.hblkhd) / 1e6;
+#else
+	return 0.0;
+#endif
+}
+
+int main() {
+	constexpr size_t count = 2000000;
+	constexpr unsigned distinct = 20000;
+
+	std::vector<std::string> names;
+	names.reserve(count);
+	std::mt19937 rng(1);
+	for (size_t i = 0; i < count; ++i)
+		names.push_back("service.requests.latency.bucket." + std::to_string(rng() % distinct));
+
+	std::vector<lzt::string> strings;
+	const double heap0 = heap_mb();
+	const double buildStrings = ms([&] {
+		strings.reserve(count);
+		for (const std::string& name : names)
+			strings.emplace_back(name.c_str());
+	});
+
+	lzt::string_pool pool;
+	std::vector<lzt::atom> atoms;
+	const double heap1 = heap_mb();
+	const double buildAtoms = ms([&] {
+		atoms.reserve(count);
+		for (const std::string& name : names)
+			atoms.push_back(pool.intern(lzt::string_view(name.data(), name.size())));
+	});
+	const double heap2 = heap_mb();
+
+	size_t equalStrings = 0, equalAtoms = 0;
+	const double compareStrings = ms([&] {
+		for (size_t i = 1; i < count; ++i)
+			equalStrings += lzt::string_view(strings[i]) == lzt::string_view(strings[i - 1]);
+	});
+	const double compareAtoms = ms([&] {
+		for (size_t i = 1; i < count; ++i)
+			equalAtoms += atoms[i] == atoms[i - 1];
+	});
+
+	std::printf("build:   strings %6.1f ms  intern %6.1f ms\n", buildStrings, buildAtoms);
+	std::printf("heap:    strings %6.1f MB  atoms + pool %6.1f MB (pool %.2f MB)\n",
+		heap1 - heap0, heap2 - heap1, pool.memory_usage() / 1e6);
+	std::printf("compare: views %6.2f ms  atoms %6.2f ms (%zu / %zu equal)\n",
+		compareStrings, compareAtoms, equalStrings, equalAtoms);
+}
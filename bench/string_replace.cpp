@@ -0,0 +1,42 @@
+// Fills a 4000-line template with two placeholders per line, once with a
+// find + replace loop and once with replace_all. Milliseconds per pass.
+//
+//   g++ -std=c++17 -O2 -I include bench/string_replace.cpp -o string_replace
+
+#include <lzt/string.h>
+#include <chrono>
+#include <cstdio>
+
+using clk = std::chrono::steady_clock;
+
+template<typename F>
+static double ms_per_pass(int passes, F f) {
+	const clk::time_point start = clk::now();
+	for (int i = 0; i < passes; ++i)
+		f();
+	return std::chrono::duration<double, std::milli>(clk::now() - start).count() / passes;
+}
+
+int main() {
+	lzt::string page;
+	for (int i = 0; i < 4000; ++i)
+		page.append("<li>{{item}} costs {{price}}</li>\n");
+
+	volatile size_t sink = 0;
+	for (int round = 0; round < 3; ++round) {
+		const double loop = ms_per_pass(5, [&] {
+			lzt::string s = page;
+			for (size_t pos = 0; (pos = s.find("{{item}}", pos)) != lzt::string::npos; pos += 6)
+				s.replace(pos, 8, "widget", 6);
+			for (size_t pos = 0; (pos = s.find("{{price}}", pos)) != lzt::string::npos; pos += 18)
+				s.replace(pos, 9, "$19.99 (incl. tax)", 18);
+			sink = s.size();
+		});
+		const double all = ms_per_pass(5, [&] {
+			lzt::string s = page;
+			s.replace_all({ { "{{item}}", "widget" }, { "{{price}}", "$19.99 (incl. tax)" } });
+			sink = s.size();
+		});
+		std::printf("find + replace loop %6.2f ms  replace_all %6.2f ms\n", loop, all);
+	}
+}
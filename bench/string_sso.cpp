@@ -0,0 +1,54 @@
+// Builds 100k short strings ("token_<n>") and counts heap allocations
+// through a replaced operator new, lzt::string against std::string.
+//
+//   g++ -std=c++17 -O2 -I include bench/string_sso.cpp -o string_sso
+
+#include <lzt/string.h>
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+	++allocations;
+	if (void* ptr = std::malloc(size))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+	std::free(ptr);
+}
+
+using clk = std::chrono::steady_clock;
+
+template<typename String>
+static void run(const char* name, size_t count) {
+	char buffer[32];
+	volatile size_t sink = 0;
+
+	allocations = 0;
+	const clk::time_point start = clk::now();
+	for (size_t i = 0; i < count; ++i) {
+		std::snprintf(buffer, sizeof(buffer), "token_%zu", i);
+		String s(buffer);
+		String copy = s;
+		sink = sink + copy.size();
+	}
+	const double ns = std::chrono::duration<double, std::nano>(clk::now() - start).count() / count;
+	std::printf("%-12s %6.1f ns per string  %.2f allocations per string\n", name, ns, double(allocations) / count);
+}
+
+int main() {
+	for (int round = 0; round < 3; ++round) {
+		run<lzt::string>("lzt::string", 100000);
+		run<std::string>("std::string", 100000);
+	}
+}
@@ -0,0 +1,42 @@
+// Element size, buffer size and scan time of a vector holding 10M
+// unique_ptr<int>, with the default deleter and with a stateless custom
+// deleter. Both should be pointer-sized.
+//
+//   g++ -std=c++17 -O2 -I include bench/unique_ptr.cpp -o unique_ptr
+
+#include <lzt/memory/unique_ptr.h>
+#include <lzt/vector.h>
+#include <chrono>
+#include <cstdio>
+
+using clk = std::chrono::steady_clock;
+
+struct int_deleter {
+	void operator()(int* ptr) const noexcept {
+		delete ptr;
+	}
+};
+
+template<typename Ptr>
+static void run(const char* name) {
+	constexpr int count = 10000000;
+	lzt::vector<Ptr> v;
+	v.reserve(count);
+	for (int i = 0; i < count; ++i)
+		v.push_back(Ptr(new int(i)));
+
+	long long live = 0;
+	const clk::time_point start = clk::now();
+	for (int round = 0; round < 5; ++round) {
+		for (const Ptr& p : v)
+			live += p.get() != nullptr;
+	}
+	const double ms = std::chrono::duration<double, std::milli>(clk::now() - start).count() / 5;
+	std::printf("%-32s sizeof %zu  buffer %4.0f MB  scan %5.1f ms (%lld)\n",
+		name, sizeof(Ptr), v.capacity() * sizeof(Ptr) / 1e6, ms, live);
+}
+
+int main() {
+	run<lzt::unique_ptr<int>>("unique_ptr<int>");
+	run<lzt::unique_ptr<int, int_deleter>>("unique_ptr<int, int_deleter>");
+}
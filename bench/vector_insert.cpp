@@ -0,0 +1,42 @@
+// Inserts batches of 4 std::string elements into the middle of a growing
+// vector 20k times, then erases them again in batches of 4 from the middle.
+//
+//   g++ -std=c++17 -O2 -I include bench/vector_insert.cpp -o vector_insert
+
+#include <lzt/vector.h>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdio>
+
+using clk = std::chrono::steady_clock;
+
+template<typename Vector>
+static void run(const char* name) {
+	const std::string batch[4] = {
+		"first element of the batch", "second element of the batch",
+		"third element of the batch", "fourth element of the batch"
+	};
+
+	Vector v;
+	clk::time_point start = clk::now();
+	for (int i = 0; i < 20000; ++i)
+		v.insert(v.begin() + v.size() / 2, batch, batch + 4);
+	const double insert = std::chrono::duration<double, std::milli>(clk::now() - start).count();
+
+	start = clk::now();
+	while (!v.empty()) {
+		const size_t offset = (v.size() - 4) / 2;
+		v.erase(v.begin() + offset, v.begin() + offset + 4);
+	}
+	const double erase = std::chrono::duration<double, std::milli>(clk::now() - start).count();
+
+	std::printf("%-12s insert %6.1f ms  erase %6.1f ms\n", name, insert, erase);
+}
+
+int main() {
+	for (int round = 0; round < 3; ++round) {
+		run<lzt::vector<std::string>>("lzt::vector");
+		run<std::vector<std::string>>("std::vector");
+	}
+}
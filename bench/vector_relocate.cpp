@@ -0,0 +1,42 @@
+// Grows vectors of 200k elements from empty, 20 rounds, so most of the
+// time is spent reallocating. lzt::string and lzt::unique_ptr are both
+// trivially relocatable and move with memmove.
+//
+//   g++ -std=c++17 -O2 -I include bench/vector_relocate.cpp -o vector_relocate
+
+#include <lzt/vector.h>
+#include <lzt/string.h>
+#include <lzt/memory/unique_ptr.h>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+
+using clk = std::chrono::steady_clock;
+
+struct node {
+	int value;
+};
+
+template<typename Vector, typename... Args>
+static double grow(Args&&... args) {
+	volatile size_t sink = 0;
+	const clk::time_point start = clk::now();
+	for (int round = 0; round < 20; ++round) {
+		Vector v;
+		for (int i = 0; i < 200000; ++i)
+			v.emplace_back(args...);
+		sink = sink + v.size();
+	}
+	return std::chrono::duration<double, std::milli>(clk::now() - start).count();
+}
+
+int main() {
+	for (int round = 0; round < 3; ++round) {
+		std::printf("lzt::vector<lzt::string> %6.1f ms  std::vector<lzt::string> %6.1f ms | ",
+			grow<lzt::vector<lzt::string>>("some string here longer"),
+			grow<std::vector<lzt::string>>("some string here longer"));
+		std::printf("lzt::vector<unique_ptr> %6.1f ms  std::vector<unique_ptr> %6.1f ms\n",
+			grow<lzt::vector<lzt::unique_ptr<node>>>(nullptr),
+			grow<std::vector<lzt::unique_ptr<node>>>(nullptr));
+	}
+}
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <stdexcept>
 #include <initializer_list>
+#include "hash.h"
 
 
 namespace lzt {
@@ -228,6 +229,30 @@ namespace lzt {
 			lhs.swap(rhs);
 		}
 
+		friend bool operator==(const array& lhs, const array& rhs) {
+			return std::equal(lhs.data(), lhs.data() + lhs.size(), rhs.data(), rhs.data() + rhs.size());
+		}
+
+		friend bool operator!=(const array& lhs, const array& rhs) {
+			return !(lhs == rhs);
+		}
+
+		friend bool operator<(const array& lhs, const array& rhs) {
+			return std::lexicographical_compare(lhs.data(), lhs.data() + lhs.size(), rhs.data(), rhs.data() + rhs.size());
+		}
+
+		friend bool operator>(const array& lhs, const array& rhs) {
+			return rhs < lhs;
+		}
+
+		friend bool operator<=(const array& lhs, const array& rhs) {
+			return !(rhs < lhs);
+		}
+
+		friend bool operator>=(const array& lhs, const array& rhs) {
+			return !(lhs < rhs);
+		}
+
 		constexpr iterator begin() noexcept {
 			return iterator(_data);
 		}
@@ -336,5 +361,15 @@ namespace lzt {
 	};
 }
 
+namespace std {
+	template<typename T, size_t Size>
+	struct hash<lzt::array<T, Size>> {
+		size_t operator()(const lzt::array<T, Size>& arr) const
+			noexcept(noexcept(lzt::hash_range(arr.data(), Size))) {
+			return lzt::hash_range(arr.data(), Size);
+		}
+	};
+}
+
 
 #endif // LZT_ARRAY_H
\ No newline at end of file
@@ -0,0 +1,312 @@
+#ifndef LZT_CONCURRENT_HASH_MAP_H
+#define LZT_CONCURRENT_HASH_MAP_H
+
+#include <new>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <optional>
+#include <shared_mutex>
+#include <type_traits>
+#include "hash.h"
+#include "flat_hash_map.h"
+#include "memory/unique_ptr.h"
+#include "memory/make_unique.h"
+
+namespace lzt {
+	namespace detail {
+		inline constexpr size_t cache_line_size = 64;
+	}
+
+	// Hash map split into independently locked shards. The shard is chosen
+	// by the top bits of the mixed hash, each shard is a flat_hash_map behind its
+	// own shared_mutex, and shards are padded to separate cache lines so
+	// readers of different shards never share a lock's line. Lookups return
+	// copies: a reference would outlive the lock.
+	template<typename Key, typename T, typename Hash = hash<Key>, typename KeyEqual = equal_to<Key>,
+		typename Allocator = std::allocator<std::pair<const Key, T>>>
+	class concurrent_hash_map {
+	public:
+		using map_type = flat_hash_map<Key, T, Hash, KeyEqual, Allocator>;
+
+		using key_type = Key;
+		using mapped_type = T;
+		using value_type = typename map_type::value_type;
+		using size_type = typename map_type::size_type;
+		using hasher = Hash;
+		using key_equal = KeyEqual;
+		using allocator_type = Allocator;
+	private:
+		// Lookups that reuse the hash the shard was chosen with.
+		struct _shard_map : map_type {
+			using map_type::map_type;
+
+			template<typename K>
+			typename map_type::const_iterator _find(const K& key, size_t hash) const {
+				return this->_make_iterator(this->_find_index(key, hash));
+			}
+
+			template<typename K, typename... Args>
+			std::pair<typename map_type::iterator, bool> _try_emplace(size_t hash, K&& key, Args&&... args) {
+				return this->_emplace_hashed(hash, key, std::piecewise_construct,
+					std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+			}
+
+			template<typename K>
+			size_type _erase(const K& key, size_t hash) {
+				return this->_erase_key(key, hash);
+			}
+		};
+
+		struct alignas(detail::cache_line_size) _shard {
+			mutable std::shared_mutex mutex;
+			_shard_map map;
+
+			_shard(const Hash& hash, const KeyEqual& equal, const Allocator& alloc)
+				: map(0, hash, equal, alloc) {}
+		};
+
+		static constexpr bool _transparent = detail::is_transparent<Hash>::value
+			&& detail::is_transparent<KeyEqual>::value;
+	public:
+		concurrent_hash_map() : concurrent_hash_map(default_shard_count()) {}
+
+		explicit concurrent_hash_map(size_type shard_count, const Hash& hash = Hash(),
+									 const KeyEqual& equal = KeyEqual(), const Allocator& alloc = Allocator())
+			: _hash(hash) {
+			while (_shard_count < shard_count && _shard_count < (size_type(1) << 16)) {
+				_shard_count *= 2;
+				++_shard_bits;
+			}
+
+			// The deleter's count tracks the shards built so far, so a throwing
+			// constructor releases exactly those.
+			_shards = unique_ptr<_shard[], aligned_deleter>(static_cast<_shard*>(
+				::operator new(sizeof(_shard) * _shard_count, std::align_val_t(alignof(_shard)))),
+				aligned_deleter{ 0, alignof(_shard) });
+			for (size_t& built = _shards.get_deleter().count; built < _shard_count; ++built)
+				::new (static_cast<void*>(_shards.get() + built)) _shard(hash, equal, alloc);
+		}
+
+		concurrent_hash_map(const concurrent_hash_map&) = delete;
+
+		concurrent_hash_map& operator=(const concurrent_hash_map&) = delete;
+
+		// Four shards per hardware thread keeps collisions between writers rare.
+		static size_type default_shard_count() noexcept {
+			const unsigned threads = std::thread::hardware_concurrency();
+			return threads == 0 ? 64 : static_cast<size_type>(threads) * 4;
+		}
+
+		size_type shard_count() const noexcept {
+			return _shard_count;
+		}
+
+		// Not a snapshot: shards are counted one at a time.
+		size_type size() const {
+			size_type count = 0;
+			for (size_type i = 0; i < _shard_count; ++i) {
+				std::shared_lock<std::shared_mutex> lock(_shards[i].mutex);
+				count += _shards[i].map.size();
+			}
+			return count;
+		}
+
+		bool empty() const {
+			return size() == 0;
+		}
+
+		std::optional<T> find(const key_type& key) const {
+			return _find(key);
+		}
+
+		template<typename K, bool U = _transparent, std::enable_if_t<U, int> = 0>
+		std::optional<T> find(const K& key) const {
+			return _find(key);
+		}
+
+		bool contains(const key_type& key) const {
+			return _contains(key);
+		}
+
+		template<typename K, bool U = _transparent, std::enable_if_t<U, int> = 0>
+		bool contains(const K& key) const {
+			return _contains(key);
+		}
+
+		// Calls f(const mapped_type&) under the shard's shared lock; avoids
+		// the copy find() makes. Returns false if the key is absent.
+		template<typename F>
+		bool visit(const key_type& key, F&& f) const {
+			const size_t hash = _hash(key);
+			const _shard& shard = _shard_for(hash);
+			std::shared_lock<std::shared_mutex> lock(shard.mutex);
+			typename map_type::const_iterator it = shard.map._find(key, hash);
+			if (it == shard.map.end())
+				return false;
+
+			f(it->second);
+			return true;
+		}
+
+		template<typename... Args>
+		bool try_emplace(const key_type& key, Args&&... args) {
+			const size_t hash = _hash(key);
+			_shard& shard = _shard_for(hash);
+			std::unique_lock<std::shared_mutex> lock(shard.mutex);
+			return shard.map._try_emplace(hash, key, std::forward<Args>(args)...).second;
+		}
+
+		template<typename... Args>
+		bool try_emplace(key_type&& key, Args&&... args) {
+			const size_t hash = _hash(key);
+			_shard& shard = _shard_for(hash);
+			std::unique_lock<std::shared_mutex> lock(shard.mutex);
+			return shard.map._try_emplace(hash, std::move(key), std::forward<Args>(args)...).second;
+		}
+
+		// Returns true if the key was inserted, false if it was assigned.
+		template<typename M>
+		bool insert_or_assign(const key_type& key, M&& obj) {
+			const size_t hash = _hash(key);
+			_shard& shard = _shard_for(hash);
+			std::unique_lock<std::shared_mutex> lock(shard.mutex);
+			std::pair<typename map_type::iterator, bool> result = shard.map._try_emplace(hash, key, std::forward<M>(obj));
+			if (!result.second)
+				result.first->second = std::forward<M>(obj);
+			return result.second;
+		}
+
+		template<typename M>
+		bool insert_or_assign(key_type&& key, M&& obj) {
+			const size_t hash = _hash(key);
+			_shard& shard = _shard_for(hash);
+			std::unique_lock<std::shared_mutex> lock(shard.mutex);
+			std::pair<typename map_type::iterator, bool> result = shard.map._try_emplace(hash, std::move(key), std::forward<M>(obj));
+			if (!result.second)
+				result.first->second = std::forward<M>(obj);
+			return result.second;
+		}
+
+		size_type erase(const key_type& key) {
+			const size_t hash = _hash(key);
+			_shard& shard = _shard_for(hash);
+			std::unique_lock<std::shared_mutex> lock(shard.mutex);
+			return shard.map._erase(key, hash);
+		}
+
+		template<typename K, bool U = _transparent, std::enable_if_t<U, int> = 0>
+		size_type erase(const K& key) {
+			const size_t hash = _hash(key);
+			_shard& shard = _shard_for(hash);
+			std::unique_lock<std::shared_mutex> lock(shard.mutex);
+			return shard.map._erase(key, hash);
+		}
+
+		// Erases every element for which pred(const value_type&) is true,
+		// locking one shard at a time. Returns the number erased.
+		template<typename Predicate>
+		size_type erase_if(Predicate pred) {
+			size_type count = 0;
+			for (size_type i = 0; i < _shard_count; ++i) {
+				std::unique_lock<std::shared_mutex> lock(_shards[i].mutex);
+				map_type& map = _shards[i].map;
+				for (typename map_type::iterator it = map.begin(); it != map.end();) {
+					if (pred(static_cast<const value_type&>(*it))) {
+						it = map.erase(it);
+						++count;
+					} else {
+						++it;
+					}
+				}
+			}
+			return count;
+		}
+
+		// Calls f(value_type&) for every element, locking one shard at a
+		// time exclusively. Mapped values may be changed; the key cannot,
+		// and nothing can be inserted into the wrong shard.
+		template<typename F>
+		void visit_all(F f) {
+			for (size_type i = 0; i < _shard_count; ++i) {
+				std::unique_lock<std::shared_mutex> lock(_shards[i].mutex);
+				for (value_type& value : _shards[i].map)
+					f(value);
+			}
+		}
+
+		// Calls f(const map_type&) for each shard under its shared lock.
+		template<typename F>
+		void for_each_shard(F f) const {
+			for (size_type i = 0; i < _shard_count; ++i) {
+				std::shared_lock<std::shared_mutex> lock(_shards[i].mutex);
+				f(static_cast<const map_type&>(_shards[i].map));
+			}
+		}
+
+		void clear() {
+			_for_each_shard([](map_type& map) { map.clear(); });
+		}
+
+		void reserve(size_type count) {
+			const size_type perShard = count / _shard_count + 1;
+			_for_each_shard([perShard](map_type& map) { map.reserve(perShard); });
+		}
+	private:
+		// Mutable access to a whole shard would let a caller insert a key
+		// into a shard its hash does not select, so this stays private.
+		template<typename F>
+		void _for_each_shard(F f) {
+			for (size_type i = 0; i < _shard_count; ++i) {
+				std::unique_lock<std::shared_mutex> lock(_shards[i].mutex);
+				f(_shards[i].map);
+			}
+		}
+
+		template<typename K>
+		std::optional<T> _find(const K& key) const {
+			const size_t hash = _hash(key);
+			const _shard& shard = _shard_for(hash);
+			std::shared_lock<std::shared_mutex> lock(shard.mutex);
+			typename map_type::const_iterator it = shard.map._find(key, hash);
+			if (it == shard.map.end())
+				return std::nullopt;
+			return it->second;
+		}
+
+		template<typename K>
+		bool _contains(const K& key) const {
+			const size_t hash = _hash(key);
+			const _shard& shard = _shard_for(hash);
+			std::shared_lock<std::shared_mutex> lock(shard.mutex);
+			return shard.map._find(key, hash) != shard.map.end();
+		}
+
+		// The hash is mixed first so that a hasher with weak high bits, such
+		// as an identity hash on integers, still spreads keys over the shards.
+		// The flat maps keep probing with the unmixed hash.
+		size_type _shard_index(size_t hash) const noexcept {
+			if (_shard_bits == 0)
+				return 0;
+			const uint64_t mixed = detail::hash_mix(hash ^ detail::hash_secret[0], detail::hash_secret[1]);
+			return static_cast<size_type>(mixed >> (64 - _shard_bits));
+		}
+
+		_shard& _shard_for(size_t hash) noexcept {
+			return _shards[_shard_index(hash)];
+		}
+
+		const _shard& _shard_for(size_t hash) const noexcept {
+			return _shards[_shard_index(hash)];
+		}
+	private:
+		unique_ptr<_shard[], aligned_deleter> _shards;
+		size_type _shard_count = 1;
+		unsigned _shard_bits = 0;
+		Hash _hash;
+	};
+}
+
+#endif // LZT_CONCURRENT_HASH_MAP_H
@@ -0,0 +1,909 @@
+#ifndef LZT_DETAIL_RAW_HASH_TABLE_H
+#define LZT_DETAIL_RAW_HASH_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <initializer_list>
+#include "simd.h"
+#include "../type_traits.h"
+#include "../memory/compressed_pair.h"
+
+namespace lzt::detail {
+    // One control byte per slot: empty, deleted, the end-of-table sentinel,
+    // or the low 7 bits of a full slot's hash.
+    using ctrl_t = signed char;
+
+    inline constexpr ctrl_t ctrl_empty = -128;
+    inline constexpr ctrl_t ctrl_deleted = -2;
+    inline constexpr ctrl_t ctrl_sentinel = -1;
+    inline constexpr size_t group_width = 16;
+
+    alignas(16) inline constexpr ctrl_t empty_group[group_width] = {
+        ctrl_sentinel, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty,
+        ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty
+    };
+
+    constexpr bool is_full(ctrl_t ctrl) noexcept {
+        return ctrl >= 0;
+    }
+
+    constexpr bool is_empty_or_deleted(ctrl_t ctrl) noexcept {
+        return ctrl < ctrl_sentinel;
+    }
+
+    // Sixteen control bytes compared at once; every match_* returns one bit
+    // per byte.
+    class ctrl_group {
+    public:
+        explicit ctrl_group(const ctrl_t* pos) noexcept {
+#if defined(LZT_HAS_SSE2)
+            _ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+#else
+            std::memcpy(_ctrl, pos, group_width);
+#endif
+        }
+
+        unsigned match(ctrl_t hash) const noexcept {
+#if defined(LZT_HAS_SSE2)
+            return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(hash), _ctrl)));
+#else
+            unsigned mask = 0;
+            for (size_t i = 0; i < group_width; ++i)
+                mask |= unsigned(_ctrl[i] == hash) << i;
+            return mask;
+#endif
+        }
+
+        unsigned match_empty() const noexcept {
+            return match(ctrl_empty);
+        }
+
+        unsigned match_empty_or_deleted() const noexcept {
+#if defined(LZT_HAS_SSE2)
+            return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(ctrl_sentinel), _ctrl)));
+#else
+            unsigned mask = 0;
+            for (size_t i = 0; i < group_width; ++i)
+                mask |= unsigned(is_empty_or_deleted(_ctrl[i])) << i;
+            return mask;
+#endif
+        }
+
+        unsigned count_leading_empty_or_deleted() const noexcept {
+            return count_trailing_zeros(match_empty_or_deleted() + 1);
+        }
+    private:
+#if defined(LZT_HAS_SSE2)
+        __m128i _ctrl;
+#else
+        ctrl_t _ctrl[group_width];
+#endif
+    };
+
+    // Triangular probing over whole groups visits every group exactly once
+    // when the table size (capacity + 1) is a power of two.
+    class probe_sequence {
+    public:
+        probe_sequence(size_t hash, size_t mask) noexcept
+            : _mask(mask), _offset(hash & mask) {}
+
+        size_t offset() const noexcept {
+            return _offset;
+        }
+
+        size_t offset(size_t i) const noexcept {
+            return (_offset + i) & _mask;
+        }
+
+        void next() noexcept {
+            _index += group_width;
+            _offset = (_offset + _index) & _mask;
+        }
+    private:
+        size_t _mask;
+        size_t _offset;
+        size_t _index = 0;
+    };
+
+    template<typename T, typename = void>
+    struct is_transparent : std::false_type {};
+
+    template<typename T>
+    struct is_transparent<T, std::void_t<typename T::is_transparent>> : std::true_type {};
+
+    template<typename Table>
+    class hash_table_const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename Table::value_type;
+        using difference_type = typename Table::difference_type;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+    public:
+        hash_table_const_iterator() noexcept = default;
+
+        hash_table_const_iterator(const ctrl_t* ctrl, value_type* slot) noexcept
+            : _ctrl(ctrl), _slot(slot) {
+            _skip_empty_or_deleted();
+        }
+
+        reference operator*() const noexcept {
+            return *_slot;
+        }
+
+        pointer operator->() const noexcept {
+            return _slot;
+        }
+
+        hash_table_const_iterator& operator++() noexcept {
+            ++_ctrl;
+            ++_slot;
+            _skip_empty_or_deleted();
+            return *this;
+        }
+
+        hash_table_const_iterator operator++(int) noexcept {
+            hash_table_const_iterator temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+        bool operator==(const hash_table_const_iterator& other) const noexcept {
+            return _ctrl == other._ctrl;
+        }
+
+        bool operator!=(const hash_table_const_iterator& other) const noexcept {
+            return !(*this == other);
+        }
+    protected:
+        void _skip_empty_or_deleted() noexcept {
+            while (is_empty_or_deleted(*_ctrl)) {
+                const unsigned shift = ctrl_group(_ctrl).count_leading_empty_or_deleted();
+                _ctrl += shift;
+                _slot += shift;
+            }
+        }
+
+        friend Table;
+
+        const ctrl_t* _ctrl = nullptr;
+        value_type* _slot = nullptr;
+    };
+
+    template<typename Table>
+    class hash_table_iterator : public hash_table_const_iterator<Table> {
+    public:
+        using myBase = hash_table_const_iterator<Table>;
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename Table::value_type;
+        using difference_type = typename Table::difference_type;
+        using pointer = value_type*;
+        using reference = value_type&;
+    public:
+        using myBase::myBase;
+
+        reference operator*() const noexcept {
+            return *this->_slot;
+        }
+
+        pointer operator->() const noexcept {
+            return this->_slot;
+        }
+
+        hash_table_iterator& operator++() noexcept {
+            myBase::operator++();
+            return *this;
+        }
+
+        hash_table_iterator operator++(int) noexcept {
+            hash_table_iterator temp = *this;
+            myBase::operator++();
+            return temp;
+        }
+    };
+
+    // Open-addressing table shared by flat_hash_map and flat_hash_set.
+    // Slots and control bytes live in one allocation: capacity slots, then
+    // capacity control bytes, the sentinel, and a copy of the first
+    // group_width - 1 control bytes so a group can be loaded at any slot.
+    // Policy supplies key_type, value_type, key(value), mapped_equal(lhs, rhs)
+    // and whether iterators are constant.
+    template<typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+    class raw_hash_table {
+    private:
+        using alloc_traits = std::allocator_traits<Allocator>;
+
+        static_assert(std::is_same_v<typename alloc_traits::value_type, typename Policy::value_type>,
+            "flat hash containers require Allocator::value_type to be value_type");
+        static_assert(std::is_same_v<typename alloc_traits::pointer, typename Policy::value_type*>,
+            "flat hash containers require an allocator with raw pointers");
+    protected:
+        static constexpr bool _transparent = is_transparent<Hash>::value && is_transparent<KeyEqual>::value;
+    public:
+        using key_type = typename Policy::key_type;
+        using value_type = typename Policy::value_type;
+        using size_type = typename alloc_traits::size_type;
+        using difference_type = typename alloc_traits::difference_type;
+        using hasher = Hash;
+        using key_equal = KeyEqual;
+        using allocator_type = Allocator;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+
+        using const_iterator = hash_table_const_iterator<raw_hash_table>;
+        using iterator = std::conditional_t<Policy::constant_iterators,
+            const_iterator, hash_table_iterator<raw_hash_table>>;
+    private:
+        // erase(iterator) would redeclare erase(const_iterator) for sets.
+        struct _no_iterator {};
+
+        using _mutable_iterator = std::conditional_t<Policy::constant_iterators, _no_iterator, iterator>;
+    public:
+        raw_hash_table() noexcept(std::is_nothrow_default_constructible_v<Hash>
+            && std::is_nothrow_default_constructible_v<KeyEqual>
+            && std::is_nothrow_default_constructible_v<Allocator>) = default;
+
+        explicit raw_hash_table(size_type bucket_count, const Hash& hash = Hash(),
+                                const KeyEqual& equal = KeyEqual(), const Allocator& alloc = Allocator())
+            : _functors(hash, equal, alloc) {
+            if (bucket_count != 0)
+                _resize(_normalize_capacity(bucket_count));
+        }
+
+        explicit raw_hash_table(const Allocator& alloc)
+            : raw_hash_table(0, Hash(), KeyEqual(), alloc) {}
+
+        template<typename InputIt>
+        raw_hash_table(InputIt first, InputIt last, size_type bucket_count = 0,
+                       const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+                       const Allocator& alloc = Allocator())
+            : raw_hash_table(bucket_count, hash, equal, alloc) {
+            insert(first, last);
+        }
+
+        raw_hash_table(std::initializer_list<value_type> init, size_type bucket_count = 0,
+                       const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(),
+                       const Allocator& alloc = Allocator())
+            : raw_hash_table(init.begin(), init.end(), bucket_count, hash, equal, alloc) {}
+
+        raw_hash_table(const raw_hash_table& other)
+            : raw_hash_table(other, alloc_traits::select_on_container_copy_construction(other._alloc())) {}
+
+        raw_hash_table(const raw_hash_table& other, const Allocator& alloc)
+            : _functors(other._hash(), other._equal(), alloc) {
+            if (other._size == 0)
+                return;
+
+            _allocate(other._capacity);
+            std::memcpy(_ctrl, other._ctrl, _capacity + group_width);
+
+            size_type i = 0;
+            try {
+                for (; i < _capacity; ++i) {
+                    if (is_full(_ctrl[i]))
+                        alloc_traits::construct(_alloc(), _slots + i, other._slots[i]);
+                }
+            } catch (...) {
+                while (i-- > 0) {
+                    if (is_full(_ctrl[i]))
+                        alloc_traits::destroy(_alloc(), _slots + i);
+                }
+                _deallocate();
+                throw;
+            }
+            _size = other._size;
+            _growth_left = other._growth_left;
+        }
+
+        raw_hash_table(raw_hash_table&& other) noexcept
+            : _functors(std::move(other._hash()), std::move(other._equal()), std::move(other._alloc())) {
+            _steal(other);
+        }
+
+        raw_hash_table(raw_hash_table&& other, const Allocator& alloc)
+            : _functors(std::move(other._hash()), std::move(other._equal()), alloc) {
+            if (alloc_traits::is_always_equal::value || _alloc() == other._alloc()) {
+                _steal(other);
+            } else {
+                reserve(other.size());
+                for (value_type& value : other)
+                    _insert_value(std::move(value));
+            }
+        }
+
+        raw_hash_table& operator=(const raw_hash_table& other) {
+            if (this == &other)
+                return *this;
+
+            raw_hash_table temp(other,
+                alloc_traits::propagate_on_container_copy_assignment::value ? other._alloc() : _alloc());
+            _swap_all(temp);
+            return *this;
+        }
+
+        raw_hash_table& operator=(raw_hash_table&& other) noexcept(
+            alloc_traits::propagate_on_container_move_assignment::value
+            || alloc_traits::is_always_equal::value) {
+
+            if (this == &other)
+                return *this;
+
+            if (alloc_traits::propagate_on_container_move_assignment::value
+                || alloc_traits::is_always_equal::value || _alloc() == other._alloc()) {
+                _tidy();
+                _hash() = std::move(other._hash());
+                _equal() = std::move(other._equal());
+                if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+                    _alloc() = std::move(other._alloc());
+                _steal(other);
+            } else {
+                clear();
+                _hash() = other._hash();
+                _equal() = other._equal();
+                reserve(other.size());
+                for (value_type& value : other)
+                    _insert_value(std::move(value));
+            }
+            return *this;
+        }
+
+        raw_hash_table& operator=(std::initializer_list<value_type> init) {
+            clear();
+            insert(init);
+            return *this;
+        }
+
+        ~raw_hash_table() {
+            _tidy();
+        }
+
+        allocator_type get_allocator() const noexcept {
+            return _alloc();
+        }
+
+        hasher hash_function() const {
+            return _hash();
+        }
+
+        key_equal key_eq() const {
+            return _equal();
+        }
+
+        iterator begin() noexcept {
+            return iterator(_ctrl, _slots);
+        }
+
+        const_iterator begin() const noexcept {
+            return const_iterator(_ctrl, _slots);
+        }
+
+        iterator end() noexcept {
+            return iterator(_ctrl + _capacity, _slots + _capacity);
+        }
+
+        const_iterator end() const noexcept {
+            return const_iterator(_ctrl + _capacity, _slots + _capacity);
+        }
+
+        const_iterator cbegin() const noexcept {
+            return begin();
+        }
+
+        const_iterator cend() const noexcept {
+            return end();
+        }
+
+        bool empty() const noexcept {
+            return _size == 0;
+        }
+
+        size_type size() const noexcept {
+            return _size;
+        }
+
+        size_type max_size() const noexcept {
+            return alloc_traits::max_size(_alloc());
+        }
+
+        size_type capacity() const noexcept {
+            return _capacity;
+        }
+
+        size_type bucket_count() const noexcept {
+            return _capacity;
+        }
+
+        float load_factor() const noexcept {
+            return _capacity == 0 ? 0.0f : static_cast<float>(_size) / static_cast<float>(_capacity);
+        }
+
+        float max_load_factor() const noexcept {
+            return 7.0f / 8.0f;
+        }
+
+        void clear() noexcept {
+            if (_capacity == 0)
+                return;
+
+            _destroy_slots();
+            _reset_ctrl();
+            _size = 0;
+            _growth_left = _capacity_to_growth(_capacity);
+        }
+
+        std::pair<iterator, bool> insert(const value_type& value) {
+            return _insert_value(value);
+        }
+
+        std::pair<iterator, bool> insert(value_type&& value) {
+            return _insert_value(std::move(value));
+        }
+
+        iterator insert(const_iterator, const value_type& value) {
+            return insert(value).first;
+        }
+
+        iterator insert(const_iterator, value_type&& value) {
+            return insert(std::move(value)).first;
+        }
+
+        template<typename InputIt>
+        void insert(InputIt first, InputIt last) {
+            for (; first != last; ++first)
+                _insert_value(*first);
+        }
+
+        void insert(std::initializer_list<value_type> ilist) {
+            insert(ilist.begin(), ilist.end());
+        }
+
+        template<typename... Args>
+        std::pair<iterator, bool> emplace(Args&&... args) {
+            return _insert_value(value_type(std::forward<Args>(args)...));
+        }
+
+        template<typename... Args>
+        iterator emplace_hint(const_iterator, Args&&... args) {
+            return emplace(std::forward<Args>(args)...).first;
+        }
+
+        iterator erase(const_iterator position) {
+            const size_type index = static_cast<size_type>(position._slot - _slots);
+            iterator next(_ctrl + index, _slots + index);
+            ++next;
+            _erase_at(index);
+            return next;
+        }
+
+        iterator erase(_mutable_iterator position) {
+            return erase(const_iterator(position));
+        }
+
+        iterator erase(const_iterator first, const_iterator last) {
+            while (first != last)
+                first = erase(first);
+            const size_type index = static_cast<size_type>(last._slot - _slots);
+            return iterator(last._ctrl, _slots + index);
+        }
+
+        size_type erase(const key_type& key) {
+            return _erase_key(key, _hash()(key));
+        }
+
+        template<typename K, bool T = _transparent, std::enable_if_t<T
+            && !std::is_convertible_v<K, iterator> && !std::is_convertible_v<K, const_iterator>, int> = 0>
+        size_type erase(const K& key) {
+            return _erase_key(key, _hash()(key));
+        }
+
+        void swap(raw_hash_table& other) noexcept {
+            using std::swap;
+            swap(_hash(), other._hash());
+            swap(_equal(), other._equal());
+            if constexpr (alloc_traits::propagate_on_container_swap::value)
+                swap(_alloc(), other._alloc());
+            _swap_storage(other);
+        }
+
+        iterator find(const key_type& key) {
+            return _make_iterator(_find_index(key, _hash()(key)));
+        }
+
+        const_iterator find(const key_type& key) const {
+            return _make_iterator(_find_index(key, _hash()(key)));
+        }
+
+        template<typename K, bool T = _transparent, std::enable_if_t<T, int> = 0>
+        iterator find(const K& key) {
+            return _make_iterator(_find_index(key, _hash()(key)));
+        }
+
+        template<typename K, bool T = _transparent, std::enable_if_t<T, int> = 0>
+        const_iterator find(const K& key) const {
+            return _make_iterator(_find_index(key, _hash()(key)));
+        }
+
+        bool contains(const key_type& key) const {
+            return _find_index(key, _hash()(key)) != _npos;
+        }
+
+        template<typename K, bool T = _transparent, std::enable_if_t<T, int> = 0>
+        bool contains(const K& key) const {
+            return _find_index(key, _hash()(key)) != _npos;
+        }
+
+        size_type count(const key_type& key) const {
+            return contains(key) ? 1 : 0;
+        }
+
+        template<typename K, bool T = _transparent, std::enable_if_t<T, int> = 0>
+        size_type count(const K& key) const {
+            return contains(key) ? 1 : 0;
+        }
+
+        void rehash(size_type bucket_count) {
+            const size_type required = _growth_to_capacity(_size);
+            const size_type newCapacity = bucket_count > required ? bucket_count : required;
+
+            if (newCapacity == 0) {
+                if (_size == 0)
+                    _tidy();
+                return;
+            }
+            _resize(_normalize_capacity(newCapacity));
+        }
+
+        void reserve(size_type count) {
+            if (count > _size + _growth_left)
+                _resize(_normalize_capacity(_growth_to_capacity(count)));
+        }
+
+        friend bool operator==(const raw_hash_table& lhs, const raw_hash_table& rhs) {
+            if (lhs.size() != rhs.size())
+                return false;
+
+            for (const value_type& value : lhs) {
+                const_iterator it = rhs.find(Policy::key(value));
+                if (it == rhs.end() || !Policy::mapped_equal(*it, value))
+                    return false;
+            }
+            return true;
+        }
+
+        friend bool operator!=(const raw_hash_table& lhs, const raw_hash_table& rhs) {
+            return !(lhs == rhs);
+        }
+
+        friend void swap(raw_hash_table& lhs, raw_hash_table& rhs) noexcept {
+            lhs.swap(rhs);
+        }
+    protected:
+        static constexpr size_type _npos = static_cast<size_type>(-1);
+
+        Hash& _hash() noexcept {
+            return _functors.first();
+        }
+
+        const Hash& _hash() const noexcept {
+            return _functors.first();
+        }
+
+        KeyEqual& _equal() noexcept {
+            return _functors.second().first();
+        }
+
+        const KeyEqual& _equal() const noexcept {
+            return _functors.second().first();
+        }
+
+        Allocator& _alloc() noexcept {
+            return _functors.second().second();
+        }
+
+        const Allocator& _alloc() const noexcept {
+            return _functors.second().second();
+        }
+
+        static ctrl_t _short_hash(size_t hash) noexcept {
+            return static_cast<ctrl_t>(hash & 0x7F);
+        }
+
+        iterator _make_iterator(size_type index) noexcept {
+            return index == _npos ? end() : iterator(_ctrl + index, _slots + index);
+        }
+
+        const_iterator _make_iterator(size_type index) const noexcept {
+            return index == _npos ? end() : const_iterator(_ctrl + index, _slots + index);
+        }
+
+        template<typename K>
+        size_type _find_index(const K& key, size_t hash) const {
+            probe_sequence seq(hash >> 7, _capacity);
+            const ctrl_t shortHash = _short_hash(hash);
+            while (true) {
+                const ctrl_group group(_ctrl + seq.offset());
+                for (unsigned mask = group.match(shortHash); mask != 0; mask &= mask - 1) {
+                    const size_type index = seq.offset(count_trailing_zeros(mask));
+                    if (_equal()(Policy::key(_slots[index]), key))
+                        return index;
+                }
+
+                if (group.match_empty() != 0)
+                    return _npos;
+                seq.next();
+            }
+        }
+
+        void _commit_insert(size_type index, size_t hash) noexcept {
+            _growth_left -= _ctrl[index] == ctrl_empty ? 1 : 0;
+            _set_ctrl(index, _short_hash(hash));
+            ++_size;
+        }
+
+        template<typename V>
+        std::pair<iterator, bool> _insert_value(V&& value) {
+            return _emplace_key(Policy::key(value), std::forward<V>(value));
+        }
+
+        // Constructs value_type from args only when key is not present yet.
+        // key and args may refer to elements of the table: when the insert
+        // has to grow it, they are consumed before the old slots go away.
+        template<typename K, typename... Args>
+        std::pair<iterator, bool> _emplace_key(const K& key, Args&&... args) {
+            return _emplace_hashed(_hash()(key), key, std::forward<Args>(args)...);
+        }
+
+        // hash must be _hash()(key).
+        template<typename K, typename... Args>
+        std::pair<iterator, bool> _emplace_hashed(size_t hash, const K& key, Args&&... args) {
+            size_type index = _find_index(key, hash);
+            if (index != _npos)
+                return { iterator(_ctrl + index, _slots + index), false };
+
+            index = _find_first_non_full(hash);
+            if (_growth_left == 0 && _ctrl[index] != ctrl_deleted) {
+                index = _rehash<true>(_grown_capacity(), hash, std::forward<Args>(args)...);
+            } else {
+                alloc_traits::construct(_alloc(), _slots + index, std::forward<Args>(args)...);
+                _commit_insert(index, hash);
+            }
+            return { iterator(_ctrl + index, _slots + index), true };
+        }
+
+        template<typename K>
+        size_type _erase_key(const K& key, size_t hash) {
+            const size_type index = _find_index(key, hash);
+            if (index == _npos)
+                return 0;
+
+            _erase_at(index);
+            return 1;
+        }
+
+        void _erase_at(size_type index) noexcept {
+            alloc_traits::destroy(_alloc(), _slots + index);
+            --_size;
+
+            // A slot may become empty again only if no probe sequence can
+            // have passed over it while it was full.
+            const size_type before = (index - group_width) & _capacity;
+            const unsigned emptyAfter = ctrl_group(_ctrl + index).match_empty();
+            const unsigned emptyBefore = ctrl_group(_ctrl + before).match_empty();
+            const bool wasNeverFull = emptyBefore != 0 && emptyAfter != 0
+                && count_trailing_zeros(emptyAfter) + (group_width - 1 - highest_bit(emptyBefore)) < group_width;
+
+            _set_ctrl(index, wasNeverFull ? ctrl_empty : ctrl_deleted);
+            _growth_left += wasNeverFull ? 1 : 0;
+        }
+    private:
+        static size_type _normalize_capacity(size_type n) noexcept {
+            size_type capacity = group_width - 1;
+            while (capacity < n)
+                capacity = capacity * 2 + 1;
+            return capacity;
+        }
+
+        // Maximum load factor of 7/8.
+        static size_type _capacity_to_growth(size_type capacity) noexcept {
+            return capacity - capacity / 8;
+        }
+
+        static size_type _growth_to_capacity(size_type growth) noexcept {
+            return growth == 0 ? 0 : growth + (growth - 1) / 7;
+        }
+
+        static size_type _allocation_size(size_type capacity) noexcept {
+            return capacity + (capacity + group_width + sizeof(value_type) - 1) / sizeof(value_type);
+        }
+
+        void _set_ctrl(size_type index, ctrl_t value) noexcept {
+            _ctrl[index] = value;
+            _ctrl[((index - (group_width - 1)) & _capacity) + (group_width - 1)] = value;
+        }
+
+        void _reset_ctrl() noexcept {
+            std::memset(_ctrl, static_cast<unsigned char>(ctrl_empty), _capacity + group_width);
+            _ctrl[_capacity] = ctrl_sentinel;
+        }
+
+        size_type _find_first_non_full(size_t hash) const noexcept {
+            probe_sequence seq(hash >> 7, _capacity);
+            while (true) {
+                const unsigned mask = ctrl_group(_ctrl + seq.offset()).match_empty_or_deleted();
+                if (mask != 0)
+                    return seq.offset(count_trailing_zeros(mask));
+                seq.next();
+            }
+        }
+
+        size_type _grown_capacity() const noexcept {
+            // Mostly tombstones: rebuild at the same size instead of growing.
+            if (_capacity > group_width && _size * 32 <= _capacity * 25)
+                return _capacity;
+            return _capacity == 0 ? group_width - 1 : _capacity * 2 + 1;
+        }
+
+        void _allocate(size_type capacity) {
+            value_type* storage = alloc_traits::allocate(_alloc(), _allocation_size(capacity));
+            _slots = storage;
+            _ctrl = reinterpret_cast<ctrl_t*>(storage + capacity);
+            _capacity = capacity;
+            _reset_ctrl();
+            _growth_left = _capacity_to_growth(capacity);
+        }
+
+        void _deallocate() noexcept {
+            if (_capacity != 0)
+                alloc_traits::deallocate(_alloc(), _slots, _allocation_size(_capacity));
+            _become_empty();
+        }
+
+        void _become_empty() noexcept {
+            _ctrl = const_cast<ctrl_t*>(empty_group);
+            _slots = nullptr;
+            _size = 0;
+            _capacity = 0;
+            _growth_left = 0;
+        }
+
+        void _destroy_slots() noexcept {
+            if constexpr (!std::is_trivially_destructible_v<value_type> || !uses_default_construct_v<Allocator>) {
+                for (size_type i = 0; i < _capacity; ++i) {
+                    if (is_full(_ctrl[i]))
+                        alloc_traits::destroy(_alloc(), _slots + i);
+                }
+            }
+        }
+
+        void _tidy() noexcept {
+            _destroy_slots();
+            _deallocate();
+        }
+
+        void _resize(size_type newCapacity) {
+            _rehash<false>(newCapacity, 0);
+        }
+
+        // Moves the elements into storage of newCapacity slots. With Insert,
+        // the element built from args goes in first, while args can still
+        // refer to the old slots. The old elements are destroyed only after
+        // everything is placed, so if Hash, the allocator or a copy throws,
+        // the table is left as it was. Returns the index of the new element.
+        template<bool Insert, typename... Args>
+        size_type _rehash(size_type newCapacity, size_t hash, Args&&... args) {
+            constexpr bool relocatable = is_trivially_relocatable_v<value_type> && uses_default_construct_v<Allocator>;
+            ctrl_t* const oldCtrl = _ctrl;
+            value_type* const oldSlots = _slots;
+            const size_type oldCapacity = _capacity;
+            const size_type oldGrowth = _growth_left;
+
+            // Hashing up front keeps a throwing Hash from interrupting the
+            // moves below, which could not be undone.
+            std::unique_ptr<size_t[]> hashes;
+            if constexpr (!std::is_nothrow_invocable_v<Hash&, const key_type&>) {
+                hashes.reset(new size_t[_size]);
+                for (size_type i = 0, n = 0; i < oldCapacity; ++i) {
+                    if (is_full(oldCtrl[i]))
+                        hashes[n++] = _hash()(Policy::key(oldSlots[i]));
+                }
+            }
+
+            _allocate(newCapacity);
+            size_type inserted = _npos;
+            try {
+                if constexpr (Insert) {
+                    inserted = _find_first_non_full(hash);
+                    alloc_traits::construct(_alloc(), _slots + inserted, std::forward<Args>(args)...);
+                    _set_ctrl(inserted, _short_hash(hash));
+                }
+
+                for (size_type i = 0, n = 0; i < oldCapacity; ++i) {
+                    if (!is_full(oldCtrl[i]))
+                        continue;
+
+                    const size_t elementHash = hashes ? hashes[n++] : _hash()(Policy::key(oldSlots[i]));
+                    const size_type index = _find_first_non_full(elementHash);
+                    if constexpr (relocatable)
+                        std::memcpy(static_cast<void*>(_slots + index), static_cast<const void*>(oldSlots + i), sizeof(value_type));
+                    else
+                        alloc_traits::construct(_alloc(), _slots + index, std::move_if_noexcept(oldSlots[i]));
+                    _set_ctrl(index, _short_hash(elementHash));
+                }
+            } catch (...) {
+                // Relocated copies cannot throw, so only the copies made by
+                // construct need destroying here.
+                if constexpr (!relocatable)
+                    _destroy_slots();
+                alloc_traits::deallocate(_alloc(), _slots, _allocation_size(_capacity));
+                _ctrl = oldCtrl;
+                _slots = oldSlots;
+                _capacity = oldCapacity;
+                _growth_left = oldGrowth;
+                throw;
+            }
+
+            _growth_left -= _size;
+            if constexpr (Insert) {
+                --_growth_left;
+                ++_size;
+            }
+
+            if (oldCapacity != 0) {
+                if constexpr (!relocatable) {
+                    for (size_type i = 0; i < oldCapacity; ++i) {
+                        if (is_full(oldCtrl[i]))
+                            alloc_traits::destroy(_alloc(), oldSlots + i);
+                    }
+                }
+                alloc_traits::deallocate(_alloc(), oldSlots, _allocation_size(oldCapacity));
+            }
+            return inserted;
+        }
+
+        void _steal(raw_hash_table& other) noexcept {
+            _ctrl = other._ctrl;
+            _slots = other._slots;
+            _size = other._size;
+            _capacity = other._capacity;
+            _growth_left = other._growth_left;
+            other._become_empty();
+        }
+
+        void _swap_storage(raw_hash_table& other) noexcept {
+            std::swap(_ctrl, other._ctrl);
+            std::swap(_slots, other._slots);
+            std::swap(_size, other._size);
+            std::swap(_capacity, other._capacity);
+            std::swap(_growth_left, other._growth_left);
+        }
+
+        // Only used by copy assignment, which built other with the
+        // allocator *this must end up with.
+        void _swap_all(raw_hash_table& other) noexcept {
+            using std::swap;
+            swap(_hash(), other._hash());
+            swap(_equal(), other._equal());
+            if constexpr (alloc_traits::propagate_on_container_copy_assignment::value)
+                swap(_alloc(), other._alloc());
+            _swap_storage(other);
+        }
+    private:
+        ctrl_t* _ctrl = const_cast<ctrl_t*>(empty_group);
+        value_type* _slots = nullptr;
+        size_type _size = 0;
+        size_type _capacity = 0;
+        size_type _growth_left = 0;
+        compressed_pair<Hash, compressed_pair<KeyEqual, Allocator>> _functors;
+    };
+}
+
+#endif // LZT_DETAIL_RAW_HASH_TABLE_H
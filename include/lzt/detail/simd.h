@@ -0,0 +1,79 @@
+#ifndef LZT_DETAIL_SIMD_H
+#define LZT_DETAIL_SIMD_H
+
+#if !defined(LZT_DISABLE_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define LZT_HAS_SSE2 1
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
+
+#if defined(LZT_HAS_SSE2) && (defined(_MSC_VER) || defined(__GNUC__) || defined(__clang__))
+#define LZT_HAS_AVX2_DISPATCH 1
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define LZT_TARGET_AVX2
+#define LZT_TARGET_SSSE3
+#else
+#define LZT_TARGET_AVX2 __attribute__((target("avx2")))
+#define LZT_TARGET_SSSE3 __attribute__((target("ssse3")))
+#endif
+
+namespace lzt::detail {
+    inline unsigned count_trailing_zeros(unsigned mask) noexcept {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+    }
+
+    inline unsigned highest_bit(unsigned mask) noexcept {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse(&index, mask);
+        return static_cast<unsigned>(index);
+#else
+        return 31u - static_cast<unsigned>(__builtin_clz(mask));
+#endif
+    }
+
+#if defined(LZT_HAS_AVX2_DISPATCH)
+    struct cpu_features {
+        bool ssse3 = false;
+        bool avx2 = false;
+    };
+
+    inline const cpu_features& cpu() noexcept {
+        static const cpu_features features = [] {
+            cpu_features result;
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            const int maxLeaf = info[0];
+
+            __cpuid(info, 1);
+            result.ssse3 = (info[2] & (1 << 9)) != 0;
+            const bool osxsave = (info[2] & (1 << 27)) != 0;
+            const bool avx = (info[2] & (1 << 28)) != 0;
+
+            if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6) {
+                __cpuidex(info, 7, 0);
+                result.avx2 = (info[1] & (1 << 5)) != 0;
+            }
+#else
+            __builtin_cpu_init();
+            result.ssse3 = __builtin_cpu_supports("ssse3");
+            result.avx2 = __builtin_cpu_supports("avx2");
+#endif
+            return result;
+        }();
+        return features;
+    }
+#endif
+}
+
+#endif // LZT_DETAIL_SIMD_H
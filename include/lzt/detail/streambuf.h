@@ -0,0 +1,35 @@
+#ifndef LZT_DETAIL_STREAMBUF_H
+#define LZT_DETAIL_STREAMBUF_H
+
+#include <streambuf>
+
+namespace lzt::detail {
+    // gptr() and egptr() are protected; a member pointer formed through a
+    // derived class can still be applied to any basic_streambuf.
+    template<typename CharT, typename Traits>
+    struct streambuf_access : std::basic_streambuf<CharT, Traits> {
+        static const CharT* get_pointer(std::basic_streambuf<CharT, Traits>* sb) {
+            return (sb->*&streambuf_access::gptr)();
+        }
+
+        static const CharT* get_end(std::basic_streambuf<CharT, Traits>* sb) {
+            return (sb->*&streambuf_access::egptr)();
+        }
+    };
+
+    // Returns the number of characters readable straight from the get
+    // area, refilling it if it is empty; -1 on end of file and 0 for an
+    // unbuffered stream that can only be read one character at a time.
+    // in_avail() is not used for this: it falls back to showmanyc(), which
+    // counts characters that are not in the get area yet.
+    template<typename CharT, typename Traits>
+    std::streamsize buffered_chars(std::basic_streambuf<CharT, Traits>* sb) {
+        if (Traits::eq_int_type(sb->sgetc(), Traits::eof()))
+            return -1;
+
+        using access = streambuf_access<CharT, Traits>;
+        return static_cast<std::streamsize>(access::get_end(sb) - access::get_pointer(sb));
+    }
+}
+
+#endif // LZT_DETAIL_STREAMBUF_H
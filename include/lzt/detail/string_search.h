@@ -0,0 +1,418 @@
+#ifndef LZT_DETAIL_STRING_SEARCH_H
+#define LZT_DETAIL_STRING_SEARCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include "simd.h"
+
+namespace lzt::detail {
+    inline constexpr size_t search_npos = static_cast<size_t>(-1);
+    inline constexpr size_t horspool_threshold = 32;
+
+    template<typename Traits>
+    inline constexpr bool is_std_char_traits_v =
+        std::is_same_v<Traits, std::char_traits<typename Traits::char_type>>;
+
+    template<typename Traits>
+    size_t find_char(const typename Traits::char_type* hay, size_t n, size_t pos,
+                     typename Traits::char_type ch) noexcept {
+        if (pos >= n)
+            return search_npos;
+
+        const auto* found = Traits::find(hay + pos, n - pos, ch);
+        return found ? static_cast<size_t>(found - hay) : search_npos;
+    }
+
+    template<typename Traits>
+    size_t rfind_char(const typename Traits::char_type* hay, size_t n, size_t pos,
+                      typename Traits::char_type ch) noexcept {
+        if (n == 0)
+            return search_npos;
+
+        for (size_t i = pos < n ? pos : n - 1; ; --i) {
+            if (Traits::eq(hay[i], ch))
+                return i;
+            if (i == 0)
+                break;
+        }
+        return search_npos;
+    }
+
+    template<typename Traits>
+    size_t search_first_char(const typename Traits::char_type* hay, size_t n, size_t pos,
+                             const typename Traits::char_type* needle, size_t m) noexcept {
+        const auto* last = hay + (n - m);
+        for (const auto* p = hay + pos; p <= last; ++p) {
+            p = Traits::find(p, static_cast<size_t>(last - p) + 1, needle[0]);
+            if (!p)
+                return search_npos;
+            if (Traits::compare(p + 1, needle + 1, m - 1) == 0)
+                return static_cast<size_t>(p - hay);
+        }
+        return search_npos;
+    }
+
+    template<typename Traits>
+    size_t search_horspool(const typename Traits::char_type* hay, size_t n, size_t pos,
+                           const typename Traits::char_type* needle, size_t m) noexcept {
+        size_t shift[256];
+        for (size_t& s : shift)
+            s = m;
+        for (size_t j = 0; j + 1 < m; ++j)
+            shift[static_cast<size_t>(needle[j]) & 0xFF] = m - 1 - j;
+
+        const auto back = needle[m - 1];
+        for (size_t i = pos; i <= n - m; ) {
+            const auto ch = hay[i + m - 1];
+            if (Traits::eq(ch, back) && Traits::compare(hay + i, needle, m - 1) == 0)
+                return i;
+            i += shift[static_cast<size_t>(ch) & 0xFF];
+        }
+        return search_npos;
+    }
+
+#if defined(LZT_HAS_SSE2)
+    inline size_t search_sse2(const char* hay, size_t n, size_t pos,
+                              const char* needle, size_t m) noexcept {
+        const __m128i first = _mm_set1_epi8(needle[0]);
+        const __m128i last = _mm_set1_epi8(needle[m - 1]);
+
+        size_t i = pos;
+        for (; i + m + 15 <= n; i += 16) {
+            const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hay + i));
+            const __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hay + i + m - 1));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(
+                _mm_cmpeq_epi8(first, blockFirst), _mm_cmpeq_epi8(last, blockLast))));
+
+            while (mask) {
+                const size_t candidate = i + count_trailing_zeros(mask);
+                if (std::memcmp(hay + candidate + 1, needle + 1, m - 2) == 0)
+                    return candidate;
+                mask &= mask - 1;
+            }
+        }
+        return search_first_char<std::char_traits<char>>(hay, n, i, needle, m);
+    }
+
+    inline size_t reverse_search_sse2(const char* hay, size_t start,
+                                      const char* needle, size_t m) noexcept {
+        const __m128i first = _mm_set1_epi8(needle[0]);
+        const __m128i last = _mm_set1_epi8(needle[m - 1]);
+
+        size_t end = start + 1;
+        for (; end >= 16; end -= 16) {
+            const size_t i = end - 16;
+            const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hay + i));
+            const __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hay + i + m - 1));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(
+                _mm_cmpeq_epi8(first, blockFirst), _mm_cmpeq_epi8(last, blockLast))));
+
+            while (mask) {
+                const unsigned bit = highest_bit(mask);
+                if (std::memcmp(hay + i + bit + 1, needle + 1, m - 2) == 0)
+                    return i + bit;
+                mask &= ~(1u << bit);
+            }
+        }
+
+        for (size_t i = end; i-- > 0; ) {
+            if (hay[i] == needle[0] && std::memcmp(hay + i + 1, needle + 1, m - 1) == 0)
+                return i;
+        }
+        return search_npos;
+    }
+#endif
+
+#if defined(LZT_HAS_AVX2_DISPATCH)
+    LZT_TARGET_AVX2 inline size_t search_avx2(const char* hay, size_t n, size_t pos,
+                                              const char* needle, size_t m) noexcept {
+        const __m256i first = _mm256_set1_epi8(needle[0]);
+        const __m256i last = _mm256_set1_epi8(needle[m - 1]);
+
+        size_t i = pos;
+        for (; i + m + 31 <= n; i += 32) {
+            const __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hay + i));
+            const __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hay + i + m - 1));
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(
+                _mm256_cmpeq_epi8(first, blockFirst), _mm256_cmpeq_epi8(last, blockLast))));
+
+            while (mask) {
+                const size_t candidate = i + count_trailing_zeros(mask);
+                if (std::memcmp(hay + candidate + 1, needle + 1, m - 2) == 0)
+                    return candidate;
+                mask &= mask - 1;
+            }
+        }
+        return search_sse2(hay, n, i, needle, m);
+    }
+#endif
+
+    // Returns the first position >= pos where needle occurs, or search_npos.
+    template<typename Traits>
+    size_t search(const typename Traits::char_type* hay, size_t n, size_t pos,
+                  const typename Traits::char_type* needle, size_t m) noexcept {
+        if (m == 0)
+            return pos <= n ? pos : search_npos;
+
+        if (pos > n || m > n - pos)
+            return search_npos;
+
+        if (m == 1)
+            return find_char<Traits>(hay, n, pos, needle[0]);
+
+        if constexpr (is_std_char_traits_v<Traits>) {
+#if defined(LZT_HAS_SSE2)
+            if constexpr (std::is_same_v<typename Traits::char_type, char>) {
+#if defined(LZT_HAS_AVX2_DISPATCH)
+                if (cpu().avx2)
+                    return search_avx2(hay, n, pos, needle, m);
+#endif
+                return search_sse2(hay, n, pos, needle, m);
+            }
+#endif
+            if (m >= horspool_threshold)
+                return search_horspool<Traits>(hay, n, pos, needle, m);
+        }
+        return search_first_char<Traits>(hay, n, pos, needle, m);
+    }
+
+    // Returns the last position <= pos where needle occurs, or search_npos.
+    template<typename Traits>
+    size_t reverse_search(const typename Traits::char_type* hay, size_t n, size_t pos,
+                          const typename Traits::char_type* needle, size_t m) noexcept {
+        if (m > n)
+            return search_npos;
+
+        const size_t start = pos < n - m ? pos : n - m;
+        if (m == 0)
+            return start;
+
+        if (m == 1)
+            return rfind_char<Traits>(hay, n, start, needle[0]);
+
+#if defined(LZT_HAS_SSE2)
+        if constexpr (is_std_char_traits_v<Traits> && std::is_same_v<typename Traits::char_type, char>)
+            return reverse_search_sse2(hay, start, needle, m);
+#endif
+
+        for (size_t i = start; ; --i) {
+            if (Traits::eq(hay[i], needle[0]) && Traits::compare(hay + i + 1, needle + 1, m - 1) == 0)
+                return i;
+            if (i == 0)
+                break;
+        }
+        return search_npos;
+    }
+
+    class byte_set {
+    public:
+        void insert(unsigned char ch) noexcept {
+            _bits[ch >> 6] |= uint64_t(1) << (ch & 63);
+        }
+
+        bool contains(unsigned char ch) const noexcept {
+            return (_bits[ch >> 6] >> (ch & 63)) & 1;
+        }
+    private:
+        uint64_t _bits[4] = {};
+    };
+
+    // Exact set membership for std char traits; wider characters are
+    // pre-filtered by their low byte before the linear check.
+    template<typename Traits>
+    class char_set {
+    public:
+        using char_type = typename Traits::char_type;
+    public:
+        char_set(const char_type* s, size_t count) noexcept : _set(s), _count(count) {
+            if constexpr (is_std_char_traits_v<Traits>) {
+                for (size_t i = 0; i < count; ++i)
+                    _filter.insert(static_cast<unsigned char>(static_cast<size_t>(s[i]) & 0xFF));
+            }
+        }
+
+        bool contains(char_type ch) const noexcept {
+            if constexpr (is_std_char_traits_v<Traits>) {
+                if (!_filter.contains(static_cast<unsigned char>(static_cast<size_t>(ch) & 0xFF)))
+                    return false;
+                if constexpr (sizeof(char_type) == 1)
+                    return true;
+            }
+            return Traits::find(_set, _count, ch) != nullptr;
+        }
+    private:
+        byte_set _filter;
+        const char_type* _set;
+        size_t _count;
+    };
+
+#if defined(LZT_HAS_AVX2_DISPATCH)
+    // Byte b is in the set iff lo[b & 0xF] & hi[b >> 4] != 0. Each distinct
+    // high nibble of the set owns one bit, so at most 8 of them fit.
+    struct nibble_tables {
+        alignas(16) unsigned char lo[16] = {};
+        alignas(16) unsigned char hi[16] = {};
+
+        bool build(const char* s, size_t count) noexcept {
+            int owner[16];
+            for (int& o : owner)
+                o = -1;
+
+            int buckets = 0;
+            for (size_t i = 0; i < count; ++i) {
+                const unsigned char ch = static_cast<unsigned char>(s[i]);
+                const unsigned high = ch >> 4;
+                if (owner[high] < 0) {
+                    if (buckets == 8)
+                        return false;
+                    owner[high] = buckets++;
+                    hi[high] = static_cast<unsigned char>(1u << owner[high]);
+                }
+                lo[ch & 0xF] |= static_cast<unsigned char>(1u << owner[high]);
+            }
+            return true;
+        }
+    };
+
+    template<bool Member>
+    LZT_TARGET_SSSE3 inline unsigned set_mask_ssse3(__m128i block, __m128i lo, __m128i hi) noexcept {
+        const __m128i low = _mm_set1_epi8(0x0F);
+        const __m128i hits = _mm_and_si128(
+            _mm_shuffle_epi8(lo, _mm_and_si128(block, low)),
+            _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi16(block, 4), low)));
+        const unsigned misses = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(hits, _mm_setzero_si128())));
+        return Member ? (~misses & 0xFFFFu) : misses;
+    }
+
+    template<bool Member>
+    LZT_TARGET_AVX2 inline unsigned set_mask_avx2(__m256i block, __m256i lo, __m256i hi) noexcept {
+        const __m256i low = _mm256_set1_epi8(0x0F);
+        const __m256i hits = _mm256_and_si256(
+            _mm256_shuffle_epi8(lo, _mm256_and_si256(block, low)),
+            _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi16(block, 4), low)));
+        const unsigned misses = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hits, _mm256_setzero_si256())));
+        return Member ? ~misses : misses;
+    }
+
+    template<bool Member>
+    LZT_TARGET_SSSE3 inline size_t scan_set_ssse3(const char* hay, size_t n, size_t& pos,
+                                                  const nibble_tables& tables) noexcept {
+        const __m128i lo = _mm_load_si128(reinterpret_cast<const __m128i*>(tables.lo));
+        const __m128i hi = _mm_load_si128(reinterpret_cast<const __m128i*>(tables.hi));
+        for (; pos + 16 <= n; pos += 16) {
+            const unsigned mask = set_mask_ssse3<Member>(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(hay + pos)), lo, hi);
+            if (mask)
+                return pos + count_trailing_zeros(mask);
+        }
+        return search_npos;
+    }
+
+    template<bool Member>
+    LZT_TARGET_SSSE3 inline size_t reverse_scan_set_ssse3(const char* hay, size_t& end,
+                                                          const nibble_tables& tables) noexcept {
+        const __m128i lo = _mm_load_si128(reinterpret_cast<const __m128i*>(tables.lo));
+        const __m128i hi = _mm_load_si128(reinterpret_cast<const __m128i*>(tables.hi));
+        for (; end >= 16; end -= 16) {
+            const unsigned mask = set_mask_ssse3<Member>(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(hay + end - 16)), lo, hi);
+            if (mask)
+                return end - 16 + highest_bit(mask);
+        }
+        return search_npos;
+    }
+
+    template<bool Member>
+    LZT_TARGET_AVX2 inline size_t scan_set_avx2(const char* hay, size_t n, size_t& pos,
+                                                const nibble_tables& tables) noexcept {
+        const __m256i lo = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(tables.lo)));
+        const __m256i hi = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(tables.hi)));
+        for (; pos + 32 <= n; pos += 32) {
+            const unsigned mask = set_mask_avx2<Member>(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hay + pos)), lo, hi);
+            if (mask)
+                return pos + count_trailing_zeros(mask);
+        }
+        return search_npos;
+    }
+
+    template<bool Member>
+    LZT_TARGET_AVX2 inline size_t reverse_scan_set_avx2(const char* hay, size_t& end,
+                                                        const nibble_tables& tables) noexcept {
+        const __m256i lo = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(tables.lo)));
+        const __m256i hi = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(tables.hi)));
+        for (; end >= 32; end -= 32) {
+            const unsigned mask = set_mask_avx2<Member>(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hay + end - 32)), lo, hi);
+            if (mask)
+                return end - 32 + highest_bit(mask);
+        }
+        return search_npos;
+    }
+#endif
+
+    // Returns the first position >= pos whose character is (Member) or is
+    // not (!Member) in [set, set + count), or search_npos.
+    template<typename Traits, bool Member>
+    size_t find_in_set(const typename Traits::char_type* hay, size_t n, size_t pos,
+                       const typename Traits::char_type* set, size_t count) noexcept {
+        if (pos >= n || (Member && count == 0))
+            return search_npos;
+
+#if defined(LZT_HAS_AVX2_DISPATCH)
+        if constexpr (is_std_char_traits_v<Traits> && std::is_same_v<typename Traits::char_type, char>) {
+            nibble_tables tables;
+            if (n - pos >= 16 && cpu().ssse3 && tables.build(set, count)) {
+                const size_t found = cpu().avx2
+                    ? scan_set_avx2<Member>(hay, n, pos, tables)
+                    : scan_set_ssse3<Member>(hay, n, pos, tables);
+                if (found != search_npos)
+                    return found;
+            }
+        }
+#endif
+
+        const char_set<Traits> members(set, count);
+        for (size_t i = pos; i < n; ++i) {
+            if (members.contains(hay[i]) == Member)
+                return i;
+        }
+        return search_npos;
+    }
+
+    // Returns the last position <= pos whose character is (Member) or is
+    // not (!Member) in [set, set + count), or search_npos.
+    template<typename Traits, bool Member>
+    size_t reverse_find_in_set(const typename Traits::char_type* hay, size_t n, size_t pos,
+                               const typename Traits::char_type* set, size_t count) noexcept {
+        if (n == 0 || (Member && count == 0))
+            return search_npos;
+
+        size_t end = (pos < n ? pos : n - 1) + 1;
+
+#if defined(LZT_HAS_AVX2_DISPATCH)
+        if constexpr (is_std_char_traits_v<Traits> && std::is_same_v<typename Traits::char_type, char>) {
+            nibble_tables tables;
+            if (end >= 16 && cpu().ssse3 && tables.build(set, count)) {
+                const size_t found = cpu().avx2
+                    ? reverse_scan_set_avx2<Member>(hay, end, tables)
+                    : reverse_scan_set_ssse3<Member>(hay, end, tables);
+                if (found != search_npos)
+                    return found;
+            }
+        }
+#endif
+
+        const char_set<Traits> members(set, count);
+        while (end-- > 0) {
+            if (members.contains(hay[end]) == Member)
+                return end;
+        }
+        return search_npos;
+    }
+}
+
+#endif // LZT_DETAIL_STRING_SEARCH_H
@@ -0,0 +1,403 @@
+#ifndef LZT_DETAIL_VECTOR_BASE_H
+#define LZT_DETAIL_VECTOR_BASE_H
+
+#include <limits>
+#include <cstring>
+#include <memory>
+#include <iterator>
+#include <stdexcept>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include "../type_traits.h"
+#include "../memory/compressed_pair.h"
+
+namespace lzt::detail {
+	// Element storage and the insert, erase and reallocation kernels shared
+	// by vector and small_vector. Derived decides where a buffer of a given
+	// capacity lives through _allocate, _deallocate, _adopt and _release,
+	// and names itself in _max_size_message.
+	template<typename Derived, typename T, typename Allocator>
+	class vector_base : private ebo_storage<Allocator> {
+	private:
+		using myAlloc = ebo_storage<Allocator>;
+	protected:
+		using alloc_traits = std::allocator_traits<Allocator>;
+		using size_type = typename alloc_traits::size_type;
+		using difference_type = typename alloc_traits::difference_type;
+		using pointer = T*;
+		using const_pointer = const T*;
+
+		static constexpr bool _relocatable =
+			is_trivially_relocatable_v<T> && uses_default_construct_v<Allocator>;
+
+		class _repeat_iterator {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = T;
+			using difference_type = typename vector_base::difference_type;
+			using pointer = const T*;
+			using reference = const T&;
+		public:
+			explicit _repeat_iterator(const T& value) noexcept : _value(std::addressof(value)) {}
+
+			reference operator*() const noexcept {
+				return *_value;
+			}
+
+			_repeat_iterator& operator++() noexcept {
+				return *this;
+			}
+
+			_repeat_iterator operator++(int) noexcept {
+				return *this;
+			}
+		private:
+			pointer _value;
+		};
+	protected:
+		vector_base() = default;
+
+		template<typename... Args>
+		explicit vector_base(std::in_place_t, Args&&... args)
+			: myAlloc(std::in_place, std::forward<Args>(args)...) {}
+
+		constexpr Allocator& _alloc() noexcept {
+			return myAlloc::get();
+		}
+
+		constexpr const Allocator& _alloc() const noexcept {
+			return myAlloc::get();
+		}
+
+		constexpr size_type _max_size() const noexcept {
+			return std::min<size_type>(alloc_traits::max_size(_alloc()),
+				std::numeric_limits<difference_type>::max());
+		}
+
+		template<typename... Args>
+		void _construct(pointer ptr, Args&&... args) {
+			alloc_traits::construct(_alloc(), ptr, std::forward<Args>(args)...);
+		}
+
+		void _construct_for_overwrite(pointer ptr) {
+			if constexpr (uses_default_construct_v<Allocator>)
+				::new (static_cast<void*>(ptr)) T;
+			else
+				_construct(ptr);
+		}
+
+		void _destroy(pointer ptr) noexcept {
+			alloc_traits::destroy(_alloc(), ptr);
+		}
+
+		static void _relocate(pointer dest, pointer first, const size_type count) noexcept {
+			if (count)
+				std::memmove(static_cast<void*>(dest), static_cast<const void*>(first), count * sizeof(T));
+		}
+
+		bool _is_inside(const_pointer ptr) const noexcept {
+			return std::less_equal<const_pointer>()(_data, ptr)
+				&& std::less<const_pointer>()(ptr, _data + _size);
+		}
+
+		void _clear() noexcept {
+			for (size_type i = 0; i < _size; i++)
+				_destroy(_data + i);
+			_size = 0;
+		}
+
+		void _tidy() noexcept {
+			_clear();
+			_derived()._release();
+		}
+
+		template<typename InputIt>
+		void _assign_elements(InputIt first, const size_type count) {
+			_clear();
+			if (_capacity < count) {
+				_derived()._release();
+				_data = _derived()._allocate(count);
+				_capacity = count;
+			}
+
+			for (size_type i = 0; i < count; ++i, ++first) {
+				_construct(_data + i, *first);
+				++_size;
+			}
+		}
+
+		// Fills empty storage with exactly count elements read from first.
+		template<typename InputIt>
+		void _construct_elements(InputIt first, const size_type count) {
+			pointer newData = _derived()._allocate(count);
+
+			size_type constructed = 0;
+			try {
+				for (; constructed < count; ++constructed, ++first)
+					_construct(newData + constructed, *first);
+			} catch (...) {
+				for (size_type i = 0; i < constructed; ++i)
+					_destroy(newData + i);
+				_derived()._deallocate(newData, count);
+				throw;
+			}
+
+			_derived()._adopt(newData, count, count);
+		}
+
+		size_type _recommend(const size_type newSize) const {
+			const size_type maxSize = _max_size();
+			if (newSize > maxSize)
+				throw std::length_error(Derived::_max_size_message);
+
+			if (_capacity > maxSize / 2)
+				return maxSize;
+			return std::max(newSize, _capacity * 2);
+		}
+
+		void _transfer_to(pointer newData, const size_type offset, const size_type gap) {
+			if constexpr (_relocatable) {
+				_relocate(newData, _data, offset);
+				_relocate(newData + offset + gap, _data + offset, _size - offset);
+			} else {
+				size_type constructed = 0;
+				try {
+					for (; constructed < _size; ++constructed) {
+						const size_type shift = constructed < offset ? 0 : gap;
+						_construct(newData + constructed + shift, std::move_if_noexcept(_data[constructed]));
+					}
+				} catch (...) {
+					for (size_type i = 0; i < constructed; ++i)
+						_destroy(newData + i + (i < offset ? 0 : gap));
+					throw;
+				}
+
+				for (size_type i = 0; i < _size; i++)
+					_destroy(_data + i);
+			}
+		}
+
+		void _reallocation(const size_type newCapacity) {
+			pointer newData = _derived()._allocate(newCapacity);
+
+			try {
+				_transfer_to(newData, _size, 0);
+			} catch (...) {
+				_derived()._deallocate(newData, newCapacity);
+				throw;
+			}
+
+			_derived()._adopt(newData, _size, newCapacity);
+		}
+
+		template<typename... Args>
+		pointer _reallocation_insert(const size_type offset, Args&&... args) {
+			const size_type newCapacity = _recommend(_size + 1);
+			pointer newData = _derived()._allocate(newCapacity);
+
+			try {
+				_construct(newData + offset, std::forward<Args>(args)...);
+			} catch (...) {
+				_derived()._deallocate(newData, newCapacity);
+				throw;
+			}
+
+			try {
+				_transfer_to(newData, offset, 1);
+			} catch (...) {
+				_destroy(newData + offset);
+				_derived()._deallocate(newData, newCapacity);
+				throw;
+			}
+
+			_derived()._adopt(newData, _size + 1, newCapacity);
+			return _data + offset;
+		}
+
+		template<typename ForwardIt>
+		void _insert_forward(const size_type offset, ForwardIt first, const size_type count) {
+			if (count == 0)
+				return;
+
+			if (count > _max_size() - _size)
+				throw std::length_error(Derived::_max_size_message);
+
+			if (_capacity - _size < count) {
+				const size_type newCapacity = _recommend(_size + count);
+				pointer newData = _derived()._allocate(newCapacity);
+
+				size_type constructed = 0;
+				try {
+					for (; constructed < count; ++constructed, ++first)
+						_construct(newData + offset + constructed, *first);
+					_transfer_to(newData, offset, count);
+				} catch (...) {
+					for (size_type i = 0; i < constructed; ++i)
+						_destroy(newData + offset + i);
+					_derived()._deallocate(newData, newCapacity);
+					throw;
+				}
+
+				_derived()._adopt(newData, _size + count, newCapacity);
+				return;
+			}
+
+			const size_type elems_after = _size - offset;
+			pointer position = _data + offset;
+
+			if constexpr (_relocatable) {
+				_relocate(position + count, position, elems_after);
+
+				size_type constructed = 0;
+				try {
+					for (; constructed < count; ++constructed, ++first)
+						_construct(position + constructed, *first);
+				} catch (...) {
+					for (size_type i = 0; i < constructed; ++i)
+						_destroy(position + i);
+					_relocate(position, position + count, elems_after);
+					throw;
+				}
+				_size += count;
+			} else {
+				pointer oldEnd = _data + _size;
+				if (elems_after > count) {
+					for (size_type i = 0; i < count; ++i, ++_size)
+						_construct(oldEnd + i, std::move(*(oldEnd - count + i)));
+
+					std::move_backward(position, oldEnd - count, oldEnd);
+					for (size_type i = 0; i < count; ++i, ++first)
+						position[i] = *first;
+				} else {
+					ForwardIt mid = std::next(first, elems_after);
+					ForwardIt it = mid;
+					for (size_type i = elems_after; i < count; ++i, ++it, ++_size)
+						_construct(_data + _size, *it);
+
+					for (size_type i = 0; i < elems_after; ++i, ++_size)
+						_construct(_data + _size, std::move(position[i]));
+
+					for (size_type i = 0; i < elems_after; ++i, ++first)
+						position[i] = *first;
+				}
+			}
+		}
+
+		template<typename... Args>
+		void _emplace_at(const size_type offset, Args&&... args) {
+			if (_size == _capacity) {
+				_reallocation_insert(offset, std::forward<Args>(args)...);
+				return;
+			}
+
+			if (offset == _size) {
+				_construct(_data + _size, std::forward<Args>(args)...);
+				++_size;
+				return;
+			}
+
+			// Built through the allocator before anything shifts, since args
+			// may refer to an element that is about to move.
+			alignas(T) unsigned char buffer[sizeof(T)];
+			pointer temp = reinterpret_cast<pointer>(buffer);
+			_construct(temp, std::forward<Args>(args)...);
+
+			if constexpr (_relocatable) {
+				_relocate(_data + offset + 1, _data + offset, _size - offset);
+				_relocate(_data + offset, temp, 1);
+				++_size;
+			} else {
+				try {
+					_construct(_data + _size, std::move(_data[_size - 1]));
+					++_size;
+
+					std::move_backward(_data + offset, _data + _size - 2, _data + _size - 1);
+					_data[offset] = std::move(*temp);
+				} catch (...) {
+					_destroy(temp);
+					throw;
+				}
+				_destroy(temp);
+			}
+		}
+
+		void _erase_range(const size_type offset, const size_type count) {
+			if (count == 0)
+				return;
+
+			if constexpr (_relocatable) {
+				for (size_type i = 0; i < count; ++i)
+					_destroy(_data + offset + i);
+
+				_relocate(_data + offset, _data + offset + count, _size - offset - count);
+			} else {
+				std::move(_data + offset + count, _data + _size, _data + offset);
+
+				for (size_type i = _size - count; i < _size; ++i)
+					_destroy(_data + i);
+			}
+
+			_size -= count;
+		}
+
+		void _resize(const size_type newSize, const T& value) {
+			if (_size < newSize) {
+				if (_capacity < newSize) {
+					if (_is_inside(std::addressof(value))) {
+						const T copy(value);
+						return _resize(newSize, copy);
+					}
+					_reallocation(_recommend(newSize));
+				}
+
+				size_type constructed = _size;
+				try {
+					for (; constructed < newSize; ++constructed)
+						_construct(_data + constructed, value);
+				} catch (...) {
+					for (size_type i = _size; i < constructed; ++i)
+						_destroy(_data + i);
+					throw;
+				}
+			} else if (newSize < _size) {
+				for (size_type i = newSize; i < _size; i++)
+					_destroy(_data + i);
+			}
+			_size = newSize;
+		}
+
+		void _resize_for_overwrite(const size_type newSize) {
+			if (_size < newSize) {
+				if (_capacity < newSize)
+					_reallocation(_recommend(newSize));
+
+				if constexpr (!std::is_trivially_default_constructible_v<T> || !uses_default_construct_v<Allocator>) {
+					size_type constructed = _size;
+					try {
+						for (; constructed < newSize; ++constructed)
+							_construct_for_overwrite(_data + constructed);
+					} catch (...) {
+						for (size_type i = _size; i < constructed; ++i)
+							_destroy(_data + i);
+						throw;
+					}
+				}
+			} else if (newSize < _size) {
+				for (size_type i = newSize; i < _size; i++)
+					_destroy(_data + i);
+			}
+			_size = newSize;
+		}
+	private:
+		Derived& _derived() noexcept {
+			return static_cast<Derived&>(*this);
+		}
+	protected:
+		pointer _data = nullptr;
+		size_type _size = 0;
+		size_type _capacity = 0;
+	};
+}
+
+#endif // LZT_DETAIL_VECTOR_BASE_H
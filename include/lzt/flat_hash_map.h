@@ -0,0 +1,173 @@
+#ifndef LZT_FLAT_HASH_MAP_H
+#define LZT_FLAT_HASH_MAP_H
+
+#include <tuple>
+#include <memory>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+#include <initializer_list>
+#include "hash.h"
+#include "detail/raw_hash_table.h"
+
+namespace lzt {
+	namespace detail {
+		template<typename Key, typename T>
+		struct map_policy {
+			using key_type = Key;
+			using value_type = std::pair<const Key, T>;
+
+			static constexpr bool constant_iterators = false;
+
+			template<typename V>
+			static const auto& key(const V& value) noexcept {
+				return value.first;
+			}
+
+			static bool mapped_equal(const value_type& lhs, const value_type& rhs) {
+				return lhs.second == rhs.second;
+			}
+		};
+	}
+
+	// Open-addressing hash map with SIMD group probing. Values are stored
+	// inline, so rehashing and erasure invalidate iterators and references.
+	template<typename Key, typename T, typename Hash = hash<Key>, typename KeyEqual = equal_to<Key>,
+		typename Allocator = std::allocator<std::pair<const Key, T>>>
+	class flat_hash_map : public detail::raw_hash_table<detail::map_policy<Key, T>, Hash, KeyEqual, Allocator> {
+	public:
+		using myBase = detail::raw_hash_table<detail::map_policy<Key, T>, Hash, KeyEqual, Allocator>;
+
+		using key_type = Key;
+		using mapped_type = T;
+		using value_type = typename myBase::value_type;
+		using size_type = typename myBase::size_type;
+		using iterator = typename myBase::iterator;
+		using const_iterator = typename myBase::const_iterator;
+	public:
+		using myBase::myBase;
+		using myBase::operator=;
+		using myBase::insert;
+
+		template<typename P, typename = std::enable_if_t<std::is_constructible_v<value_type, P&&>>>
+		std::pair<iterator, bool> insert(P&& value) {
+			return emplace(std::forward<P>(value));
+		}
+
+		template<typename P, typename = std::enable_if_t<std::is_constructible_v<value_type, P&&>>>
+		iterator insert(const_iterator, P&& value) {
+			return emplace(std::forward<P>(value)).first;
+		}
+
+		template<typename... Args>
+		std::pair<iterator, bool> emplace(Args&&... args) {
+			if constexpr (_is_key_and_mapped<Args...>()) {
+				return try_emplace(std::forward<Args>(args)...);
+			} else {
+				return myBase::emplace(std::forward<Args>(args)...);
+			}
+		}
+
+		template<typename... Args>
+		iterator emplace_hint(const_iterator, Args&&... args) {
+			return emplace(std::forward<Args>(args)...).first;
+		}
+
+		template<typename... Args>
+		std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+			return this->_emplace_key(key, std::piecewise_construct,
+				std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+		}
+
+		template<typename... Args>
+		std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+			return this->_emplace_key(key, std::piecewise_construct,
+				std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+		}
+
+		template<typename... Args>
+		iterator try_emplace(const_iterator, const key_type& key, Args&&... args) {
+			return try_emplace(key, std::forward<Args>(args)...).first;
+		}
+
+		template<typename... Args>
+		iterator try_emplace(const_iterator, key_type&& key, Args&&... args) {
+			return try_emplace(std::move(key), std::forward<Args>(args)...).first;
+		}
+
+		template<typename M>
+		std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) {
+			std::pair<iterator, bool> result = try_emplace(key, std::forward<M>(obj));
+			if (!result.second)
+				result.first->second = std::forward<M>(obj);
+			return result;
+		}
+
+		template<typename M>
+		std::pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj) {
+			std::pair<iterator, bool> result = try_emplace(std::move(key), std::forward<M>(obj));
+			if (!result.second)
+				result.first->second = std::forward<M>(obj);
+			return result;
+		}
+
+		template<typename M>
+		iterator insert_or_assign(const_iterator, const key_type& key, M&& obj) {
+			return insert_or_assign(key, std::forward<M>(obj)).first;
+		}
+
+		template<typename M>
+		iterator insert_or_assign(const_iterator, key_type&& key, M&& obj) {
+			return insert_or_assign(std::move(key), std::forward<M>(obj)).first;
+		}
+
+		T& operator[](const key_type& key) {
+			return try_emplace(key).first->second;
+		}
+
+		T& operator[](key_type&& key) {
+			return try_emplace(std::move(key)).first->second;
+		}
+
+		T& at(const key_type& key) {
+			iterator it = this->find(key);
+			if (it == this->end())
+				throw std::out_of_range("at: key not found");
+			return it->second;
+		}
+
+		const T& at(const key_type& key) const {
+			const_iterator it = this->find(key);
+			if (it == this->end())
+				throw std::out_of_range("at: key not found");
+			return it->second;
+		}
+
+		template<typename K, bool U = myBase::_transparent, std::enable_if_t<U, int> = 0>
+		T& at(const K& key) {
+			iterator it = this->find(key);
+			if (it == this->end())
+				throw std::out_of_range("at: key not found");
+			return it->second;
+		}
+
+		template<typename K, bool U = myBase::_transparent, std::enable_if_t<U, int> = 0>
+		const T& at(const K& key) const {
+			const_iterator it = this->find(key);
+			if (it == this->end())
+				throw std::out_of_range("at: key not found");
+			return it->second;
+		}
+	private:
+		// emplace(key, mapped) skips building a pair when the key is present.
+		template<typename... Args>
+		static constexpr bool _is_key_and_mapped() noexcept {
+			if constexpr (sizeof...(Args) == 2)
+				return std::is_same_v<std::decay_t<std::tuple_element_t<0, std::tuple<Args...>>>, key_type>;
+			else
+				return false;
+		}
+	};
+}
+
+#endif // LZT_FLAT_HASH_MAP_H
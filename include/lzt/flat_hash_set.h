@@ -0,0 +1,40 @@
+#ifndef LZT_FLAT_HASH_SET_H
+#define LZT_FLAT_HASH_SET_H
+
+#include <memory>
+#include "hash.h"
+#include "detail/raw_hash_table.h"
+
+namespace lzt {
+	namespace detail {
+		template<typename Key>
+		struct set_policy {
+			using key_type = Key;
+			using value_type = Key;
+
+			static constexpr bool constant_iterators = true;
+
+			static const Key& key(const Key& value) noexcept {
+				return value;
+			}
+
+			static bool mapped_equal(const Key&, const Key&) noexcept {
+				return true;
+			}
+		};
+	}
+
+	// Open-addressing hash set with SIMD group probing. Elements are stored
+	// inline, so rehashing and erasure invalidate iterators and references.
+	template<typename Key, typename Hash = hash<Key>, typename KeyEqual = equal_to<Key>,
+		typename Allocator = std::allocator<Key>>
+	class flat_hash_set : public detail::raw_hash_table<detail::set_policy<Key>, Hash, KeyEqual, Allocator> {
+	public:
+		using myBase = detail::raw_hash_table<detail::set_policy<Key>, Hash, KeyEqual, Allocator>;
+	public:
+		using myBase::myBase;
+		using myBase::operator=;
+	};
+}
+
+#endif // LZT_FLAT_HASH_SET_H
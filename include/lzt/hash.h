@@ -0,0 +1,174 @@
+#ifndef LZT_HASH_H
+#define LZT_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <utility>
+#include <type_traits>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace lzt {
+	// Types whose equal values always have equal object representations
+	// (no padding, no float +0/-0 or NaN) are hashed as raw bytes.
+	// Specialize this for such user types to opt in.
+	template<typename T>
+	struct is_contiguously_hashable : std::bool_constant<
+		std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>> {};
+
+	template<typename T, size_t N>
+	struct is_contiguously_hashable<T[N]> : is_contiguously_hashable<T> {};
+
+	template<typename T>
+	inline constexpr bool is_contiguously_hashable_v = is_contiguously_hashable<T>::value;
+
+	namespace detail {
+		inline constexpr uint64_t hash_secret[4] = {
+			0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+			0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+		};
+
+		inline void multiply_128(uint64_t& lo, uint64_t& hi) noexcept {
+#if defined(__SIZEOF_INT128__)
+			const __uint128_t product = static_cast<__uint128_t>(lo) * hi;
+			lo = static_cast<uint64_t>(product);
+			hi = static_cast<uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+			lo = _umul128(lo, hi, &hi);
+#else
+			const uint64_t ha = lo >> 32, la = static_cast<uint32_t>(lo);
+			const uint64_t hb = hi >> 32, lb = static_cast<uint32_t>(hi);
+			const uint64_t hh = ha * hb, hl = ha * lb, lh = la * hb, ll = la * lb;
+			const uint64_t middle = hl + (ll >> 32) + static_cast<uint32_t>(lh);
+			lo = (middle << 32) | static_cast<uint32_t>(ll);
+			hi = hh + (middle >> 32) + (lh >> 32);
+#endif
+		}
+
+		inline uint64_t hash_mix(uint64_t a, uint64_t b) noexcept {
+			multiply_128(a, b);
+			return a ^ b;
+		}
+
+		inline uint64_t read_64(const unsigned char* p) noexcept {
+			uint64_t value;
+			std::memcpy(&value, p, sizeof(value));
+			return value;
+		}
+
+		inline uint64_t read_32(const unsigned char* p) noexcept {
+			uint32_t value;
+			std::memcpy(&value, p, sizeof(value));
+			return value;
+		}
+
+		// hash_mix(hash_secret[0], hash_secret[1]): the mixed form of seed 0.
+		inline constexpr uint64_t hash_default_seed = 0xca813bf4c7abf0a9ull;
+
+		// wyhash (final version 4): 48 bytes per round in three independent
+		// multiply chains, short keys in a single 128-bit multiply.
+		inline size_t hash_bytes_mixed(const unsigned char* p, size_t len, uint64_t seed) noexcept {
+			uint64_t a, b;
+			if (len <= 16) {
+				if (len >= 4) {
+					const size_t step = (len >> 3) << 2;
+					a = (read_32(p) << 32) | read_32(p + step);
+					b = (read_32(p + len - 4) << 32) | read_32(p + len - 4 - step);
+				} else if (len > 0) {
+					a = (uint64_t(p[0]) << 16) | (uint64_t(p[len >> 1]) << 8) | p[len - 1];
+					b = 0;
+				} else {
+					a = b = 0;
+				}
+			} else {
+				size_t i = len;
+				if (i > 48) {
+					uint64_t seed1 = seed, seed2 = seed;
+					do {
+						seed = hash_mix(read_64(p) ^ hash_secret[1], read_64(p + 8) ^ seed);
+						seed1 = hash_mix(read_64(p + 16) ^ hash_secret[2], read_64(p + 24) ^ seed1);
+						seed2 = hash_mix(read_64(p + 32) ^ hash_secret[3], read_64(p + 40) ^ seed2);
+						p += 48;
+						i -= 48;
+					} while (i > 48);
+					seed ^= seed1 ^ seed2;
+				}
+
+				while (i > 16) {
+					seed = hash_mix(read_64(p) ^ hash_secret[1], read_64(p + 8) ^ seed);
+					p += 16;
+					i -= 16;
+				}
+				a = read_64(p + i - 16);
+				b = read_64(p + i - 8);
+			}
+
+			a ^= hash_secret[1];
+			b ^= seed;
+			multiply_128(a, b);
+			return static_cast<size_t>(hash_mix(a ^ hash_secret[0] ^ len, b ^ hash_secret[1]));
+		}
+	}
+
+	inline size_t hash_bytes(const void* data, size_t len) noexcept {
+		return detail::hash_bytes_mixed(static_cast<const unsigned char*>(data), len, detail::hash_default_seed);
+	}
+
+	inline size_t hash_bytes(const void* data, size_t len, uint64_t seed) noexcept {
+		seed ^= detail::hash_mix(seed ^ detail::hash_secret[0], detail::hash_secret[1]);
+		return detail::hash_bytes_mixed(static_cast<const unsigned char*>(data), len, seed);
+	}
+
+	inline size_t hash_combine(size_t seed, size_t value) noexcept {
+		return static_cast<size_t>(detail::hash_mix(seed ^ detail::hash_secret[0], value ^ detail::hash_secret[1]));
+	}
+
+	template<typename T>
+	struct hash {
+		size_t operator()(const T& value) const noexcept(_is_nothrow()) {
+			if constexpr (is_contiguously_hashable_v<T> && sizeof(T) <= sizeof(uint64_t)) {
+				uint64_t bits = 0;
+				std::memcpy(&bits, &value, sizeof(T));
+				return static_cast<size_t>(detail::hash_mix(bits ^ detail::hash_secret[0], detail::hash_secret[1]));
+			} else if constexpr (is_contiguously_hashable_v<T>) {
+				return hash_bytes(&value, sizeof(T));
+			} else {
+				return std::hash<T>()(value);
+			}
+		}
+	private:
+		static constexpr bool _is_nothrow() noexcept {
+			if constexpr (is_contiguously_hashable_v<T>)
+				return true;
+			else
+				return noexcept(std::hash<T>()(std::declval<const T&>()));
+		}
+	};
+
+	// Specialized with is_transparent next to hash<T> for types that can be
+	// looked up by a cheaper key, e.g. strings by string_view.
+	template<typename T>
+	struct equal_to {
+		bool operator()(const T& lhs, const T& rhs) const noexcept(noexcept(lhs == rhs)) {
+			return lhs == rhs;
+		}
+	};
+
+	template<typename T>
+	size_t hash_range(const T* first, size_t count) noexcept(noexcept(hash<T>()(*first))) {
+		if constexpr (is_contiguously_hashable_v<T>) {
+			return hash_bytes(first, count * sizeof(T));
+		} else {
+			size_t seed = hash_combine(0, count);
+			for (size_t i = 0; i < count; ++i)
+				seed = hash_combine(seed, hash<T>()(first[i]));
+			return seed;
+		}
+	}
+}
+
+#endif // LZT_HASH_H
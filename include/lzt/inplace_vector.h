@@ -0,0 +1,474 @@
+#ifndef LZT_INPLACE_VECTOR_H
+#define LZT_INPLACE_VECTOR_H
+
+#include <new>
+#include <cstring>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <initializer_list>
+#include "hash.h"
+#include "array.h"
+#include "type_traits.h"
+
+namespace lzt {
+	namespace detail {
+		// Raw storage for up to N elements. For trivially copyable T every
+		// special member is defaulted, which keeps inplace_vector<T, N>
+		// trivially copyable; otherwise only the live elements are copied.
+		template<typename T, size_t N, bool = std::is_trivially_copyable_v<T>>
+		class inplace_storage {
+		public:
+			T* _elems() noexcept {
+				return reinterpret_cast<T*>(_buffer);
+			}
+
+			const T* _elems() const noexcept {
+				return reinterpret_cast<const T*>(_buffer);
+			}
+
+			alignas(T) unsigned char _buffer[N == 0 ? 1 : N * sizeof(T)];
+			size_t _size = 0;
+		};
+
+		template<typename T, size_t N>
+		class inplace_storage<T, N, false> {
+		public:
+			inplace_storage() noexcept = default;
+
+			inplace_storage(const inplace_storage& other) {
+				std::uninitialized_copy(other._elems(), other._elems() + other._size, _elems());
+				_size = other._size;
+			}
+
+			inplace_storage(inplace_storage&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+				std::uninitialized_move(other._elems(), other._elems() + other._size, _elems());
+				_size = other._size;
+			}
+
+			inplace_storage& operator=(const inplace_storage& other) {
+				if (this != &other)
+					_assign(other._elems(), other._size);
+				return *this;
+			}
+
+			inplace_storage& operator=(inplace_storage&& other) noexcept(
+				std::is_nothrow_move_assignable_v<T> && std::is_nothrow_move_constructible_v<T>) {
+				if (this != &other)
+					_assign(std::make_move_iterator(other._elems()), other._size);
+				return *this;
+			}
+
+			~inplace_storage() {
+				std::destroy(_elems(), _elems() + _size);
+			}
+
+			T* _elems() noexcept {
+				return reinterpret_cast<T*>(_buffer);
+			}
+
+			const T* _elems() const noexcept {
+				return reinterpret_cast<const T*>(_buffer);
+			}
+
+			alignas(T) unsigned char _buffer[N == 0 ? 1 : N * sizeof(T)];
+			size_t _size = 0;
+		private:
+			// Assigns over the live prefix, then constructs or destroys the rest.
+			template<typename InputIt>
+			void _assign(InputIt first, size_t count) {
+				const size_t common = std::min(count, _size);
+				for (size_t i = 0; i < common; ++i, ++first)
+					_elems()[i] = *first;
+
+				if (count > _size) {
+					for (; _size < count; ++_size, ++first)
+						::new (static_cast<void*>(_elems() + _size)) T(*first);
+				} else {
+					std::destroy(_elems() + count, _elems() + _size);
+					_size = count;
+				}
+			}
+		};
+	}
+
+	// Vector with a fixed capacity of N elements stored inside the object,
+	// so it never allocates. Operations that would exceed N throw
+	// std::length_error; the try_ variants return nullptr instead.
+	template<typename T, size_t N>
+	class inplace_vector : private detail::inplace_storage<T, N> {
+	public:
+		using value_type = T;
+		using size_type = size_t;
+		using difference_type = ptrdiff_t;
+		using pointer = T*;
+		using const_pointer = const T*;
+		using reference = T&;
+		using const_reference = const T&;
+
+		using const_iterator = array_const_iterator<T>;
+		using iterator = array_iterator<T>;
+
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+	public:
+		inplace_vector() noexcept = default;
+
+		explicit inplace_vector(size_type count) {
+			resize(count);
+		}
+
+		inplace_vector(size_type count, const T& value) {
+			resize(count, value);
+		}
+
+		template<typename InputIt, std::enable_if_t<std::is_convertible_v<
+			typename std::iterator_traits<InputIt>::iterator_category, std::input_iterator_tag>, int> = 0>
+		inplace_vector(InputIt first, InputIt last) {
+			if constexpr (std::is_convertible_v<typename std::iterator_traits<InputIt>::iterator_category,
+				std::forward_iterator_tag>) {
+				if (static_cast<size_type>(std::distance(first, last)) > N)
+					throw std::length_error("inplace_vector: capacity exceeded");
+				for (; first != last; ++first)
+					unchecked_emplace_back(*first);
+			} else {
+				for (; first != last; ++first)
+					emplace_back(*first);
+			}
+		}
+
+		inplace_vector(std::initializer_list<T> init)
+			: inplace_vector(init.begin(), init.end()) {}
+
+		inplace_vector& operator=(std::initializer_list<T> init) {
+			if (init.size() > N)
+				throw std::length_error("inplace_vector: capacity exceeded");
+
+			clear();
+			for (const T& value : init)
+				unchecked_emplace_back(value);
+			return *this;
+		}
+
+		reference at(const size_type index) {
+			if (this->_size <= index)
+				throw std::out_of_range("index is out of range");
+			return data()[index];
+		}
+
+		const_reference at(const size_type index) const {
+			if (this->_size <= index)
+				throw std::out_of_range("index is out of range");
+			return data()[index];
+		}
+
+		reference operator[](const size_type index) noexcept {
+			return data()[index];
+		}
+
+		const_reference operator[](const size_type index) const noexcept {
+			return data()[index];
+		}
+
+		reference front() noexcept {
+			return data()[0];
+		}
+
+		const_reference front() const noexcept {
+			return data()[0];
+		}
+
+		reference back() noexcept {
+			return data()[this->_size - 1];
+		}
+
+		const_reference back() const noexcept {
+			return data()[this->_size - 1];
+		}
+
+		pointer data() noexcept {
+			return this->_elems();
+		}
+
+		const_pointer data() const noexcept {
+			return this->_elems();
+		}
+
+		iterator begin() noexcept {
+			return iterator(data());
+		}
+
+		const_iterator begin() const noexcept {
+			return const_iterator(data());
+		}
+
+		iterator end() noexcept {
+			return iterator(data() + this->_size);
+		}
+
+		const_iterator end() const noexcept {
+			return const_iterator(data() + this->_size);
+		}
+
+		reverse_iterator rbegin() noexcept {
+			return reverse_iterator(end());
+		}
+
+		const_reverse_iterator rbegin() const noexcept {
+			return const_reverse_iterator(end());
+		}
+
+		reverse_iterator rend() noexcept {
+			return reverse_iterator(begin());
+		}
+
+		const_reverse_iterator rend() const noexcept {
+			return const_reverse_iterator(begin());
+		}
+
+		const_iterator cbegin() const noexcept {
+			return begin();
+		}
+
+		const_iterator cend() const noexcept {
+			return end();
+		}
+
+		const_reverse_iterator crbegin() const noexcept {
+			return rbegin();
+		}
+
+		const_reverse_iterator crend() const noexcept {
+			return rend();
+		}
+
+		bool empty() const noexcept {
+			return this->_size == 0;
+		}
+
+		bool full() const noexcept {
+			return this->_size == N;
+		}
+
+		size_type size() const noexcept {
+			return this->_size;
+		}
+
+		static constexpr size_type max_size() noexcept {
+			return N;
+		}
+
+		static constexpr size_type capacity() noexcept {
+			return N;
+		}
+
+		void clear() noexcept {
+			std::destroy(data(), data() + this->_size);
+			this->_size = 0;
+		}
+
+		template<typename... Args>
+		reference emplace_back(Args&&... args) {
+			if (full())
+				throw std::length_error("inplace_vector: capacity exceeded");
+			return unchecked_emplace_back(std::forward<Args>(args)...);
+		}
+
+		void push_back(const T& value) {
+			emplace_back(value);
+		}
+
+		void push_back(T&& value) {
+			emplace_back(std::move(value));
+		}
+
+		template<typename... Args>
+		pointer try_emplace_back(Args&&... args) {
+			if (full())
+				return nullptr;
+			return std::addressof(unchecked_emplace_back(std::forward<Args>(args)...));
+		}
+
+		pointer try_push_back(const T& value) {
+			return try_emplace_back(value);
+		}
+
+		pointer try_push_back(T&& value) {
+			return try_emplace_back(std::move(value));
+		}
+
+		// Precondition: !full().
+		template<typename... Args>
+		reference unchecked_emplace_back(Args&&... args) {
+			pointer slot = data() + this->_size;
+			::new (static_cast<void*>(slot)) T(std::forward<Args>(args)...);
+			++this->_size;
+			return *slot;
+		}
+
+		void pop_back() noexcept {
+			--this->_size;
+			std::destroy_at(data() + this->_size);
+		}
+
+		template<typename... Args>
+		iterator emplace(const_iterator pos, Args&&... args) {
+			const size_type offset = _offset_of(pos);
+			emplace_back(std::forward<Args>(args)...);
+			std::rotate(data() + offset, data() + this->_size - 1, data() + this->_size);
+			return begin() + offset;
+		}
+
+		iterator insert(const_iterator pos, const T& value) {
+			return emplace(pos, value);
+		}
+
+		iterator insert(const_iterator pos, T&& value) {
+			return emplace(pos, std::move(value));
+		}
+
+		iterator insert(const_iterator pos, size_type count, const T& value) {
+			const size_type offset = _offset_of(pos);
+			if (count > N - this->_size)
+				throw std::length_error("inplace_vector: capacity exceeded");
+
+			const size_type oldSize = this->_size;
+			for (size_type i = 0; i < count; ++i)
+				unchecked_emplace_back(value);
+			std::rotate(data() + offset, data() + oldSize, data() + this->_size);
+			return begin() + offset;
+		}
+
+		// Elements are appended and rotated into place; if an element
+		// throws, the ones already appended stay at the end. A forward range
+		// that does not fit throws before anything is appended; a single-pass
+		// range can only find out once the vector is full.
+		template<typename InputIt, std::enable_if_t<std::is_convertible_v<
+			typename std::iterator_traits<InputIt>::iterator_category, std::input_iterator_tag>, int> = 0>
+		iterator insert(const_iterator pos, InputIt first, InputIt last) {
+			const size_type offset = _offset_of(pos);
+			const size_type oldSize = this->_size;
+			if constexpr (std::is_convertible_v<typename std::iterator_traits<InputIt>::iterator_category,
+				std::forward_iterator_tag>) {
+				if (static_cast<size_type>(std::distance(first, last)) > N - this->_size)
+					throw std::length_error("inplace_vector: capacity exceeded");
+				for (; first != last; ++first)
+					unchecked_emplace_back(*first);
+			} else {
+				for (; first != last; ++first)
+					emplace_back(*first);
+			}
+			std::rotate(data() + offset, data() + oldSize, data() + this->_size);
+			return begin() + offset;
+		}
+
+		iterator insert(const_iterator pos, std::initializer_list<T> ilist) {
+			return insert(pos, ilist.begin(), ilist.end());
+		}
+
+		iterator erase(const_iterator pos) {
+			return erase(pos, pos + 1);
+		}
+
+		iterator erase(const_iterator first, const_iterator last) {
+			if (first < cbegin() || last > cend() || first > last)
+				throw std::out_of_range("inplace_vector::erase - invalid range");
+
+			const size_type offset = first - cbegin();
+			const size_type count = last - first;
+			pointer newEnd = std::move(data() + offset + count, data() + this->_size, data() + offset);
+			std::destroy(newEnd, data() + this->_size);
+			this->_size -= count;
+			return begin() + offset;
+		}
+
+		void resize(size_type newSize) {
+			_resize(newSize, [this]() { unchecked_emplace_back(); });
+		}
+
+		void resize(size_type newSize, const T& value) {
+			_resize(newSize, [this, &value]() { unchecked_emplace_back(value); });
+		}
+
+		void swap(inplace_vector& other) noexcept(std::is_nothrow_swappable_v<T>
+			&& std::is_nothrow_move_constructible_v<T>) {
+			inplace_vector& shorter = this->_size < other._size ? *this : other;
+			inplace_vector& longer = this->_size < other._size ? other : *this;
+
+			const size_type common = shorter._size;
+			std::swap_ranges(shorter.data(), shorter.data() + common, longer.data());
+			for (size_type i = common; i < longer._size; ++i)
+				shorter.unchecked_emplace_back(std::move(longer.data()[i]));
+			std::destroy(longer.data() + common, longer.data() + longer._size);
+			longer._size = common;
+		}
+
+		friend void swap(inplace_vector& lhs, inplace_vector& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+			lhs.swap(rhs);
+		}
+
+		friend bool operator==(const inplace_vector& lhs, const inplace_vector& rhs) {
+			return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+		}
+
+		friend bool operator!=(const inplace_vector& lhs, const inplace_vector& rhs) {
+			return !(lhs == rhs);
+		}
+
+		friend bool operator<(const inplace_vector& lhs, const inplace_vector& rhs) {
+			return std::lexicographical_compare(lhs.data(), lhs.data() + lhs.size(), rhs.data(), rhs.data() + rhs.size());
+		}
+
+		friend bool operator>(const inplace_vector& lhs, const inplace_vector& rhs) {
+			return rhs < lhs;
+		}
+
+		friend bool operator<=(const inplace_vector& lhs, const inplace_vector& rhs) {
+			return !(rhs < lhs);
+		}
+
+		friend bool operator>=(const inplace_vector& lhs, const inplace_vector& rhs) {
+			return !(lhs < rhs);
+		}
+	private:
+		size_type _offset_of(const_iterator pos) const {
+			if (pos < cbegin() || pos > cend())
+				throw std::out_of_range("inplace_vector insert position out of range");
+			return static_cast<size_type>(pos - cbegin());
+		}
+
+		template<typename Append>
+		void _resize(size_type newSize, Append append) {
+			if (newSize > N)
+				throw std::length_error("inplace_vector: capacity exceeded");
+
+			if (newSize < this->_size) {
+				std::destroy(data() + newSize, data() + this->_size);
+				this->_size = newSize;
+			}
+			while (this->_size < newSize)
+				append();
+		}
+	};
+
+	static_assert(std::is_trivially_copyable_v<inplace_vector<int, 4>>,
+		"inplace_vector of a trivially copyable type must be trivially copyable");
+
+	template<typename T, size_t N>
+	struct is_trivially_relocatable<inplace_vector<T, N>>
+		: std::bool_constant<is_trivially_relocatable_v<T>> {};
+}
+
+namespace std {
+	template<typename T, size_t N>
+	struct hash<lzt::inplace_vector<T, N>> {
+		size_t operator()(const lzt::inplace_vector<T, N>& vec) const
+			noexcept(noexcept(lzt::hash_range(vec.data(), vec.size()))) {
+			return lzt::hash_range(vec.data(), vec.size());
+		}
+	};
+}
+
+#endif // LZT_INPLACE_VECTOR_H
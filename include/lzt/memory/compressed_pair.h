@@ -0,0 +1,78 @@
+#ifndef LZT_COMPRESSED_PAIR_H
+#define LZT_COMPRESSED_PAIR_H
+
+#include <utility>
+#include <type_traits>
+
+namespace lzt {
+	template<typename T, bool = std::is_empty_v<T> && !std::is_final_v<T>>
+	class ebo_storage : private T {
+	public:
+		constexpr ebo_storage() = default;
+
+		template<typename... Args>
+		constexpr explicit ebo_storage(std::in_place_t, Args&&... args)
+			: T(std::forward<Args>(args)...) {}
+
+		constexpr T& get() noexcept {
+			return *this;
+		}
+
+		constexpr const T& get() const noexcept {
+			return *this;
+		}
+	};
+
+	template<typename T>
+	class ebo_storage<T, false> {
+	public:
+		constexpr ebo_storage() = default;
+
+		template<typename... Args>
+		constexpr explicit ebo_storage(std::in_place_t, Args&&... args)
+			: _value(std::forward<Args>(args)...) {}
+
+		constexpr T& get() noexcept {
+			return _value;
+		}
+
+		constexpr const T& get() const noexcept {
+			return _value;
+		}
+	private:
+		T _value{};
+	};
+
+	template<typename First, typename Second>
+	class compressed_pair : private ebo_storage<First> {
+	public:
+		using myBase = ebo_storage<First>;
+	public:
+		constexpr compressed_pair() = default;
+
+		template<typename F, typename... Args,
+			typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, compressed_pair>>>
+		constexpr compressed_pair(F&& first, Args&&... second)
+			: myBase(std::in_place, std::forward<F>(first)), _second(std::forward<Args>(second)...) {}
+
+		constexpr First& first() noexcept {
+			return myBase::get();
+		}
+
+		constexpr const First& first() const noexcept {
+			return myBase::get();
+		}
+
+		constexpr Second& second() noexcept {
+			return _second;
+		}
+
+		constexpr const Second& second() const noexcept {
+			return _second;
+		}
+	private:
+		Second _second{};
+	};
+}
+
+#endif // LZT_COMPRESSED_PAIR_H
@@ -0,0 +1,122 @@
+#ifndef LZT_HUGE_PAGE_H
+#define LZT_HUGE_PAGE_H
+
+#include <new>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "unique_ptr.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LZT_HAS_MMAP
+#include <sys/mman.h>
+#endif
+
+namespace lzt {
+	namespace detail {
+		inline constexpr size_t huge_page_size = 2 * 1024 * 1024;
+
+		// Anonymous mapping of whole huge pages, aligned to a huge page and
+		// advised for transparent huge pages. Pages read as zero until
+		// written. Returns nullptr if mapping is unavailable or fails.
+		inline void* map_huge_pages(size_t bytes) noexcept {
+#if defined(LZT_HAS_MMAP)
+			if (bytes > static_cast<size_t>(-1) - 2 * huge_page_size)
+				return nullptr;
+
+			const size_t length = (bytes + huge_page_size - 1) & ~(huge_page_size - 1);
+			const size_t reserved = length + huge_page_size;
+			void* raw = ::mmap(nullptr, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (raw == MAP_FAILED)
+				return nullptr;
+
+			unsigned char* begin = static_cast<unsigned char*>(raw);
+			unsigned char* aligned = reinterpret_cast<unsigned char*>(
+				(reinterpret_cast<uintptr_t>(begin) + huge_page_size - 1) & ~(huge_page_size - 1));
+			if (aligned != begin)
+				::munmap(begin, aligned - begin);
+			if (aligned + length != begin + reserved)
+				::munmap(aligned + length, begin + reserved - (aligned + length));
+#if defined(MADV_HUGEPAGE)
+			::madvise(aligned, length, MADV_HUGEPAGE);
+#endif
+			return aligned;
+#else
+			(void)bytes;
+			return nullptr;
+#endif
+		}
+
+		inline void unmap_huge_pages(void* ptr, size_t bytes) noexcept {
+#if defined(LZT_HAS_MMAP)
+			::munmap(ptr, (bytes + huge_page_size - 1) & ~(huge_page_size - 1));
+#else
+			(void)ptr;
+			(void)bytes;
+#endif
+		}
+	}
+
+	// Destroys count elements, then unmaps the pages or, for buffers that
+	// fell back to the heap (mapped_bytes == 0), frees them.
+	struct huge_page_deleter {
+		size_t count = 0;
+		size_t mapped_bytes = 0;
+		size_t alignment = alignof(std::max_align_t);
+
+		template<typename T>
+		void operator()(T* ptr) const noexcept {
+			std::destroy_n(ptr, count);
+			if (mapped_bytes != 0)
+				detail::unmap_huge_pages(ptr, mapped_bytes);
+			else
+				::operator delete(static_cast<void*>(ptr), std::align_val_t(alignment));
+		}
+	};
+
+	// Value-initialized array for large buffers. At least one huge page
+	// (2 MiB) worth is mapped on huge-page boundaries with MADV_HUGEPAGE, so
+	// the kernel can back it with transparent huge pages; fresh pages are
+	// already zero, so arithmetic, enum and pointer elements, whose value
+	// initialization is all zero bits, are not written at all. Other types,
+	// such as pointers to data members (null is -1), are value-initialized
+	// as usual. Smaller requests, platforms without mmap and failed
+	// mappings fall back to cache-line aligned operator new.
+	template<typename T>
+	std::enable_if_t<std::is_array_v<T>&& std::extent_v<T> == 0, unique_ptr<T, huge_page_deleter>>
+		make_unique_huge(size_t size) {
+		using element = std::remove_extent_t<T>;
+
+		if (size > static_cast<size_t>(-1) / sizeof(element))
+			throw std::bad_array_new_length();
+
+		const size_t bytes = size * sizeof(element);
+		huge_page_deleter deleter{ size, 0, alignof(element) > 64 ? alignof(element) : 64 };
+		element* data = nullptr;
+		if (bytes >= detail::huge_page_size && alignof(element) <= detail::huge_page_size)
+			data = static_cast<element*>(detail::map_huge_pages(bytes));
+
+		if (data) {
+			deleter.mapped_bytes = bytes;
+		} else {
+			data = static_cast<element*>(::operator new(bytes, std::align_val_t(deleter.alignment)));
+		}
+
+		constexpr bool zeroIsValue = std::is_arithmetic_v<element> || std::is_enum_v<element> || std::is_pointer_v<element>;
+		if (!deleter.mapped_bytes || !zeroIsValue) {
+			try {
+				std::uninitialized_value_construct_n(data, size);
+			} catch (...) {
+				if (deleter.mapped_bytes)
+					detail::unmap_huge_pages(data, bytes);
+				else
+					::operator delete(static_cast<void*>(data), std::align_val_t(deleter.alignment));
+				throw;
+			}
+		}
+		return unique_ptr<T, huge_page_deleter>(data, deleter);
+	}
+}
+
+#endif // LZT_HUGE_PAGE_H
@@ -2,7 +2,11 @@
 #ifndef LZT_MAKE_UNIQUE_H
 #define LZT_MAKE_UNIQUE_H
 
+#include <new>
+#include <memory>
 #include <utility>
+#include <cstddef>
+#include <stdexcept>
 #include <type_traits>
 #include "unique_ptr.h"
 
@@ -16,12 +20,78 @@ namespace lzt {
 	template<typename T>
 	std::enable_if_t<std::is_array_v<T>&& std::extent_v<T> == 0, unique_ptr<T>>
 		make_unique(size_t size) {
-		return unique_ptr<T[]>(new T[size]());
+		return unique_ptr<T>(new std::remove_extent_t<T>[size]());
 	}
 
 	template<typename T, typename... Args>
 	std::enable_if_t<std::is_array_v<T>&& std::extent_v<T> != 0, void>
 		make_unique(Args&&...) = delete;
+
+	// Default-initializes: trivial types are left uninitialized instead of zeroed.
+	template<typename T>
+	std::enable_if_t<!std::is_array_v<T>, unique_ptr<T>>
+		make_unique_for_overwrite() {
+		return unique_ptr<T>(new T);
+	}
+
+	template<typename T>
+	std::enable_if_t<std::is_array_v<T>&& std::extent_v<T> == 0, unique_ptr<T>>
+		make_unique_for_overwrite(size_t size) {
+		return unique_ptr<T>(new std::remove_extent_t<T>[size]);
+	}
+
+	template<typename T, typename... Args>
+	std::enable_if_t<std::is_array_v<T>&& std::extent_v<T> != 0, void>
+		make_unique_for_overwrite(Args&&...) = delete;
+
+	// Destroys count elements and frees memory from aligned operator new.
+	struct aligned_deleter {
+		size_t count = 0;
+		size_t alignment = alignof(std::max_align_t);
+
+		template<typename T>
+		void operator()(T* ptr) const noexcept {
+			std::destroy_n(ptr, count);
+			::operator delete(static_cast<void*>(ptr), std::align_val_t(alignment));
+		}
+	};
+
+	namespace detail {
+		template<typename T, bool ValueInit>
+		unique_ptr<T[], aligned_deleter> make_aligned_array(size_t size, size_t alignment) {
+			if (alignment < alignof(T))
+				alignment = alignof(T);
+			if ((alignment & (alignment - 1)) != 0)
+				throw std::invalid_argument("make_unique_aligned: alignment is not a power of two");
+			if (size > static_cast<size_t>(-1) / sizeof(T))
+				throw std::bad_array_new_length();
+
+			T* data = static_cast<T*>(::operator new(size * sizeof(T), std::align_val_t(alignment)));
+			try {
+				if constexpr (ValueInit)
+					std::uninitialized_value_construct_n(data, size);
+				else
+					std::uninitialized_default_construct_n(data, size);
+			} catch (...) {
+				::operator delete(static_cast<void*>(data), std::align_val_t(alignment));
+				throw;
+			}
+			return unique_ptr<T[], aligned_deleter>(data, aligned_deleter{ size, alignment });
+		}
+	}
+
+	// Array aligned to at least alignof(T); alignment must be a power of two.
+	template<typename T>
+	std::enable_if_t<std::is_array_v<T>&& std::extent_v<T> == 0, unique_ptr<T, aligned_deleter>>
+		make_unique_aligned(size_t size, size_t alignment = alignof(std::remove_extent_t<T>)) {
+		return detail::make_aligned_array<std::remove_extent_t<T>, true>(size, alignment);
+	}
+
+	template<typename T>
+	std::enable_if_t<std::is_array_v<T>&& std::extent_v<T> == 0, unique_ptr<T, aligned_deleter>>
+		make_unique_aligned_for_overwrite(size_t size, size_t alignment = alignof(std::remove_extent_t<T>)) {
+		return detail::make_aligned_array<std::remove_extent_t<T>, false>(size, alignment);
+	}
 }
 
-#endif // LZT_MAKE_UNIQUE_H
\ No newline at end of file
+#endif // LZT_MAKE_UNIQUE_H
@@ -0,0 +1,112 @@
+#ifndef LZT_MEMORY_RESOURCE_H
+#define LZT_MEMORY_RESOURCE_H
+
+#include <new>
+#include <atomic>
+#include <cstddef>
+
+namespace lzt::memory {
+	// Type-erased source of raw memory for polymorphic_allocator.
+	class memory_resource {
+	public:
+		static constexpr size_t max_align = alignof(std::max_align_t);
+	public:
+		virtual ~memory_resource() = default;
+
+		[[nodiscard]] void* allocate(size_t bytes, size_t alignment = max_align) {
+			return do_allocate(bytes, alignment);
+		}
+
+		void deallocate(void* ptr, size_t bytes, size_t alignment = max_align) {
+			do_deallocate(ptr, bytes, alignment);
+		}
+
+		bool is_equal(const memory_resource& other) const noexcept {
+			return do_is_equal(other);
+		}
+
+		friend bool operator==(const memory_resource& lhs, const memory_resource& rhs) noexcept {
+			return &lhs == &rhs || lhs.is_equal(rhs);
+		}
+
+		friend bool operator!=(const memory_resource& lhs, const memory_resource& rhs) noexcept {
+			return !(lhs == rhs);
+		}
+	private:
+		virtual void* do_allocate(size_t bytes, size_t alignment) = 0;
+
+		virtual void do_deallocate(void* ptr, size_t bytes, size_t alignment) = 0;
+
+		virtual bool do_is_equal(const memory_resource& other) const noexcept = 0;
+	};
+
+	namespace detail {
+		class new_delete_resource final : public memory_resource {
+		private:
+			void* do_allocate(size_t bytes, size_t alignment) override {
+				if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+					return ::operator new(bytes, std::align_val_t(alignment));
+				return ::operator new(bytes);
+			}
+
+			void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+				if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+					::operator delete(ptr, bytes, std::align_val_t(alignment));
+				else
+					::operator delete(ptr, bytes);
+			}
+
+			bool do_is_equal(const memory_resource& other) const noexcept override {
+				return this == &other;
+			}
+		};
+
+		class null_memory_resource final : public memory_resource {
+		private:
+			void* do_allocate(size_t, size_t) override {
+				throw std::bad_alloc();
+			}
+
+			void do_deallocate(void*, size_t, size_t) override {}
+
+			bool do_is_equal(const memory_resource& other) const noexcept override {
+				return this == &other;
+			}
+		};
+
+		// Function-local statics are never destroyed, so the resources stay
+		// usable from other objects' destructors at exit.
+		template<typename Resource>
+		Resource* immortal_resource() noexcept {
+			alignas(Resource) static unsigned char storage[sizeof(Resource)];
+			static Resource* resource = ::new (static_cast<void*>(storage)) Resource();
+			return resource;
+		}
+
+		inline std::atomic<memory_resource*>& default_resource() noexcept {
+			static std::atomic<memory_resource*> resource(immortal_resource<new_delete_resource>());
+			return resource;
+		}
+	}
+
+	inline memory_resource* new_delete_resource() noexcept {
+		return detail::immortal_resource<detail::new_delete_resource>();
+	}
+
+	inline memory_resource* null_memory_resource() noexcept {
+		return detail::immortal_resource<detail::null_memory_resource>();
+	}
+
+	inline memory_resource* get_default_resource() noexcept {
+		return detail::default_resource().load(std::memory_order_acquire);
+	}
+
+	// Passing nullptr restores new_delete_resource(). Returns the previous resource.
+	inline memory_resource* set_default_resource(memory_resource* resource) noexcept {
+		if (!resource)
+			resource = new_delete_resource();
+		return detail::default_resource().exchange(resource, std::memory_order_acq_rel);
+	}
+}
+
+#endif // LZT_MEMORY_RESOURCE_H
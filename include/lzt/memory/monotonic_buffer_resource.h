@@ -0,0 +1,112 @@
+#ifndef LZT_MONOTONIC_BUFFER_RESOURCE_H
+#define LZT_MONOTONIC_BUFFER_RESOURCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include "memory_resource.h"
+
+namespace lzt::memory {
+	// Bump allocator: deallocate() does nothing and everything is returned
+	// at once by release() or the destructor. Starts in the caller's buffer
+	// if one is given, then takes chunks from upstream, each twice the size
+	// of the previous one.
+	class monotonic_buffer_resource : public memory_resource {
+	public:
+		static constexpr size_t default_initial_size = 1024;
+	public:
+		monotonic_buffer_resource() noexcept
+			: monotonic_buffer_resource(get_default_resource()) {}
+
+		explicit monotonic_buffer_resource(memory_resource* upstream) noexcept
+			: monotonic_buffer_resource(default_initial_size, upstream) {}
+
+		explicit monotonic_buffer_resource(size_t initial_size, memory_resource* upstream = get_default_resource()) noexcept
+			: _upstream(upstream), _initialNext(initial_size == 0 ? 1 : initial_size), _nextSize(_initialNext) {}
+
+		monotonic_buffer_resource(void* buffer, size_t size, memory_resource* upstream = get_default_resource()) noexcept
+			: _upstream(upstream), _buffer(static_cast<unsigned char*>(buffer)), _bufferSize(size),
+			  _current(_buffer), _end(_buffer + size),
+			  _initialNext(size == 0 ? default_initial_size : size * 2), _nextSize(_initialNext) {}
+
+		monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+
+		monotonic_buffer_resource& operator=(const monotonic_buffer_resource&) = delete;
+
+		~monotonic_buffer_resource() override {
+			release();
+		}
+
+		// Frees every chunk and starts over from the initial buffer.
+		void release() noexcept {
+			while (_chunks) {
+				_chunk* next = _chunks->next;
+				_upstream->deallocate(_chunks, _chunks->size, alignof(_chunk));
+				_chunks = next;
+			}
+
+			_current = _buffer;
+			_end = _buffer + _bufferSize;
+			_nextSize = _initialNext;
+		}
+
+		memory_resource* upstream_resource() const noexcept {
+			return _upstream;
+		}
+	private:
+		struct alignas(max_align) _chunk {
+			_chunk* next;
+			size_t size;
+		};
+
+		static unsigned char* _align_up(unsigned char* ptr, size_t alignment) noexcept {
+			const uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+			return ptr + ((alignment - address % alignment) % alignment);
+		}
+
+		void* do_allocate(size_t bytes, size_t alignment) override {
+			unsigned char* result = _current ? _align_up(_current, alignment) : nullptr;
+			if (!result || result > _end || static_cast<size_t>(_end - result) < bytes) {
+				_grow(bytes, alignment);
+				result = _align_up(_current, alignment);
+			}
+
+			_current = result + bytes;
+			return result;
+		}
+
+		void do_deallocate(void*, size_t, size_t) override {}
+
+		bool do_is_equal(const memory_resource& other) const noexcept override {
+			return this == &other;
+		}
+
+		void _grow(size_t bytes, size_t alignment) {
+			size_t needed = sizeof(_chunk) + bytes + (alignment > alignof(_chunk) ? alignment : 0);
+			if (needed < bytes)
+				throw std::bad_alloc();
+
+			size_t size = _nextSize;
+			while (size < needed)
+				size = size > SIZE_MAX / 2 ? needed : size * 2;
+
+			_chunk* chunk = ::new (_upstream->allocate(size, alignof(_chunk))) _chunk{ _chunks, size };
+			_chunks = chunk;
+
+			_current = reinterpret_cast<unsigned char*>(chunk + 1);
+			_end = reinterpret_cast<unsigned char*>(chunk) + size;
+			_nextSize = size > SIZE_MAX / 2 ? size : size * 2;
+		}
+	private:
+		memory_resource* _upstream;
+		unsigned char* _buffer = nullptr;
+		size_t _bufferSize = 0;
+		unsigned char* _current = nullptr;
+		unsigned char* _end = nullptr;
+		_chunk* _chunks = nullptr;
+		size_t _initialNext;
+		size_t _nextSize;
+	};
+}
+
+#endif // LZT_MONOTONIC_BUFFER_RESOURCE_H
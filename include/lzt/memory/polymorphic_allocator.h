@@ -0,0 +1,170 @@
+#ifndef LZT_POLYMORPHIC_ALLOCATOR_H
+#define LZT_POLYMORPHIC_ALLOCATOR_H
+
+#include <new>
+#include <tuple>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include "memory_resource.h"
+#include "../type_traits.h"
+
+namespace lzt::memory {
+	namespace detail {
+		// Whether construct() hands Alloc to the new object, which for a pair
+		// means to either member.
+		template<typename T, typename Alloc>
+		struct passes_allocator : std::uses_allocator<T, Alloc> {};
+
+		template<typename T1, typename T2, typename Alloc>
+		struct passes_allocator<std::pair<T1, T2>, Alloc>
+			: std::bool_constant<std::uses_allocator_v<T1, Alloc> || std::uses_allocator_v<T2, Alloc>> {};
+
+		template<typename T>
+		struct is_pair : std::false_type {};
+
+		template<typename T1, typename T2>
+		struct is_pair<std::pair<T1, T2>> : std::true_type {};
+	}
+
+	// Allocator that forwards to a memory_resource chosen at run time, so
+	// containers with different resources share one type. Containers pass
+	// it on to elements that use allocators when they construct them.
+	template<typename T = std::byte>
+	class polymorphic_allocator {
+	public:
+		using value_type = T;
+	public:
+		polymorphic_allocator() noexcept : _resource(get_default_resource()) {}
+
+		polymorphic_allocator(memory_resource* resource) noexcept : _resource(resource) {}
+
+		polymorphic_allocator(const polymorphic_allocator& other) = default;
+
+		template<typename U>
+		polymorphic_allocator(const polymorphic_allocator<U>& other) noexcept
+			: _resource(other.resource()) {}
+
+		polymorphic_allocator& operator=(const polymorphic_allocator&) = delete;
+
+		[[nodiscard]] T* allocate(size_t count) {
+			if (count > static_cast<size_t>(-1) / sizeof(T))
+				throw std::bad_array_new_length();
+			return static_cast<T*>(_resource->allocate(count * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T* ptr, size_t count) noexcept {
+			_resource->deallocate(ptr, count * sizeof(T), alignof(T));
+		}
+
+		[[nodiscard]] void* allocate_bytes(size_t bytes, size_t alignment = memory_resource::max_align) {
+			return _resource->allocate(bytes, alignment);
+		}
+
+		void deallocate_bytes(void* ptr, size_t bytes, size_t alignment = memory_resource::max_align) noexcept {
+			_resource->deallocate(ptr, bytes, alignment);
+		}
+
+		// Uses-allocator construction: U receives this allocator either as
+		// (std::allocator_arg, alloc, args...) or as a trailing argument.
+		template<typename U, typename... Args>
+		std::enable_if_t<!detail::is_pair<U>::value> construct(U* ptr, Args&&... args) {
+			if constexpr (!std::uses_allocator_v<U, polymorphic_allocator>) {
+				::new (static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+			} else if constexpr (std::is_constructible_v<U, std::allocator_arg_t, const polymorphic_allocator&, Args...>) {
+				::new (static_cast<void*>(ptr)) U(std::allocator_arg, *this, std::forward<Args>(args)...);
+			} else {
+				static_assert(std::is_constructible_v<U, Args..., const polymorphic_allocator&>,
+					"polymorphic_allocator: type uses allocators but cannot be constructed with one");
+				::new (static_cast<void*>(ptr)) U(std::forward<Args>(args)..., *this);
+			}
+		}
+
+		// Pairs pass the allocator on to each member, as std::pmr does.
+		template<typename T1, typename T2, typename... Args1, typename... Args2>
+		void construct(std::pair<T1, T2>* ptr, std::piecewise_construct_t,
+					   std::tuple<Args1...> first, std::tuple<Args2...> second) {
+			::new (static_cast<void*>(ptr)) std::pair<T1, T2>(std::piecewise_construct,
+				_uses_allocator_args<T1>(std::move(first)), _uses_allocator_args<T2>(std::move(second)));
+		}
+
+		template<typename T1, typename T2>
+		void construct(std::pair<T1, T2>* ptr) {
+			construct(ptr, std::piecewise_construct, std::tuple<>(), std::tuple<>());
+		}
+
+		template<typename T1, typename T2, typename U, typename V>
+		void construct(std::pair<T1, T2>* ptr, U&& first, V&& second) {
+			construct(ptr, std::piecewise_construct,
+				std::forward_as_tuple(std::forward<U>(first)), std::forward_as_tuple(std::forward<V>(second)));
+		}
+
+		template<typename T1, typename T2, typename U, typename V>
+		void construct(std::pair<T1, T2>* ptr, const std::pair<U, V>& other) {
+			construct(ptr, std::piecewise_construct,
+				std::forward_as_tuple(other.first), std::forward_as_tuple(other.second));
+		}
+
+		template<typename T1, typename T2, typename U, typename V>
+		void construct(std::pair<T1, T2>* ptr, std::pair<U, V>&& other) {
+			construct(ptr, std::piecewise_construct,
+				std::forward_as_tuple(std::forward<U>(other.first)), std::forward_as_tuple(std::forward<V>(other.second)));
+		}
+
+		template<typename U>
+		void destroy(U* ptr) noexcept {
+			ptr->~U();
+		}
+
+		// Copies of a container go back to the default resource.
+		polymorphic_allocator select_on_container_copy_construction() const noexcept {
+			return polymorphic_allocator();
+		}
+
+		memory_resource* resource() const noexcept {
+			return _resource;
+		}
+
+		template<typename U>
+		friend bool operator==(const polymorphic_allocator& lhs, const polymorphic_allocator<U>& rhs) noexcept {
+			return *lhs.resource() == *rhs.resource();
+		}
+
+		template<typename U>
+		friend bool operator!=(const polymorphic_allocator& lhs, const polymorphic_allocator<U>& rhs) noexcept {
+			return !(lhs == rhs);
+		}
+	private:
+		// The constructor arguments for U with this allocator added the way
+		// construct(U*, args...) would add it.
+		template<typename U, typename Tuple>
+		auto _uses_allocator_args(Tuple&& args) const noexcept {
+			return std::apply([this](auto&&... elems) {
+				if constexpr (!std::uses_allocator_v<U, polymorphic_allocator>) {
+					return std::forward_as_tuple(std::forward<decltype(elems)>(elems)...);
+				} else if constexpr (std::is_constructible_v<U, std::allocator_arg_t, const polymorphic_allocator&, decltype(elems)...>) {
+					return std::forward_as_tuple(std::allocator_arg, *this, std::forward<decltype(elems)>(elems)...);
+				} else {
+					static_assert(std::is_constructible_v<U, decltype(elems)..., const polymorphic_allocator&>,
+						"polymorphic_allocator: type uses allocators but cannot be constructed with one");
+					return std::forward_as_tuple(std::forward<decltype(elems)>(elems)..., *this);
+				}
+			}, std::forward<Tuple>(args));
+		}
+	private:
+		memory_resource* _resource;
+	};
+}
+
+namespace lzt {
+	// construct() only differs from placement new for element types that
+	// take an allocator, so everything else keeps the memmove paths.
+	template<typename T>
+	struct uses_default_construct<memory::polymorphic_allocator<T>>
+		: std::bool_constant<!memory::detail::passes_allocator<T, memory::polymorphic_allocator<T>>::value> {};
+
+	template<typename T>
+	struct is_trivially_relocatable<memory::polymorphic_allocator<T>> : std::true_type {};
+}
+
+#endif // LZT_POLYMORPHIC_ALLOCATOR_H
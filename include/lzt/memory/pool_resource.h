@@ -0,0 +1,261 @@
+#ifndef LZT_POOL_RESOURCE_H
+#define LZT_POOL_RESOURCE_H
+
+#include <new>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+#include "memory_resource.h"
+#include "../detail/simd.h"
+
+namespace lzt::memory {
+	struct pool_options {
+		size_t max_blocks_per_chunk = 0;
+		size_t largest_required_pool_block = 0;
+	};
+
+	// Power-of-two size classes from 8 bytes up to largest_required_pool_block,
+	// each a free list carved from chunks that double up to
+	// max_blocks_per_chunk blocks. Larger or over-aligned requests go to
+	// upstream and are tracked so release() can return them too.
+	class unsynchronized_pool_resource : public memory_resource {
+	public:
+		static constexpr size_t default_max_blocks_per_chunk = 4096;
+		static constexpr size_t default_largest_block = 4096;
+		static constexpr size_t max_largest_block = size_t(1) << 20;
+	public:
+		unsynchronized_pool_resource()
+			: unsynchronized_pool_resource(pool_options(), get_default_resource()) {}
+
+		explicit unsynchronized_pool_resource(memory_resource* upstream)
+			: unsynchronized_pool_resource(pool_options(), upstream) {}
+
+		explicit unsynchronized_pool_resource(const pool_options& options,
+											  memory_resource* upstream = get_default_resource())
+			: _upstream(upstream), _options(_normalize(options)) {
+			_poolCount = _class_of(_options.largest_required_pool_block) + 1;
+			for (unsigned i = 0; i < _poolCount; ++i)
+				_pools[i].blockSize = _min_block << i;
+		}
+
+		unsynchronized_pool_resource(const unsynchronized_pool_resource&) = delete;
+
+		unsynchronized_pool_resource& operator=(const unsynchronized_pool_resource&) = delete;
+
+		~unsynchronized_pool_resource() override {
+			release();
+		}
+
+		void release() noexcept {
+			for (unsigned i = 0; i < _poolCount; ++i) {
+				_pool& pool = _pools[i];
+				while (pool.chunks) {
+					_chunk* next = pool.chunks->next;
+					_upstream->deallocate(pool.chunks, pool.chunks->size, alignof(_chunk));
+					pool.chunks = next;
+				}
+				pool.free = nullptr;
+				pool.bump = pool.bumpEnd = nullptr;
+				pool.nextBlocks = 0;
+			}
+
+			while (_large) {
+				_large_header* next = _large->next;
+				_upstream->deallocate(_large->block, _large->size, _large->alignment);
+				_large = next;
+			}
+		}
+
+		memory_resource* upstream_resource() const noexcept {
+			return _upstream;
+		}
+
+		pool_options options() const noexcept {
+			return _options;
+		}
+	private:
+		static constexpr size_t _min_block = 8;
+		static constexpr unsigned _max_pools = 18;
+
+		struct _free_block {
+			_free_block* next;
+		};
+
+		struct alignas(max_align) _chunk {
+			_chunk* next;
+			size_t size;
+		};
+
+		struct _pool {
+			_free_block* free = nullptr;
+			unsigned char* bump = nullptr;
+			unsigned char* bumpEnd = nullptr;
+			_chunk* chunks = nullptr;
+			size_t blockSize = 0;
+			size_t nextBlocks = 0;
+		};
+
+		// Sits right before every large allocation.
+		struct _large_header {
+			_large_header* prev;
+			_large_header* next;
+			void* block;
+			size_t size;
+			size_t alignment;
+		};
+
+		static pool_options _normalize(pool_options options) noexcept {
+			if (options.max_blocks_per_chunk == 0)
+				options.max_blocks_per_chunk = default_max_blocks_per_chunk;
+			if (options.largest_required_pool_block == 0)
+				options.largest_required_pool_block = default_largest_block;
+			if (options.largest_required_pool_block > max_largest_block)
+				options.largest_required_pool_block = max_largest_block;
+			if (options.largest_required_pool_block < _min_block)
+				options.largest_required_pool_block = _min_block;
+
+			options.largest_required_pool_block = _min_block << _class_of(options.largest_required_pool_block);
+			return options;
+		}
+
+		static unsigned _class_of(size_t bytes) noexcept {
+			if (bytes <= _min_block)
+				return 0;
+			return lzt::detail::highest_bit(static_cast<unsigned>(bytes - 1)) + 1 - 3;
+		}
+
+		void* do_allocate(size_t bytes, size_t alignment) override {
+			const size_t size = bytes > alignment ? bytes : alignment;
+			if (size > _options.largest_required_pool_block || alignment > max_align)
+				return _allocate_large(bytes, alignment);
+
+			_pool& pool = _pools[_class_of(size)];
+			if (_free_block* block = pool.free) {
+				pool.free = block->next;
+				return block;
+			}
+
+			if (pool.bump == pool.bumpEnd)
+				_refill(pool);
+
+			void* result = pool.bump;
+			pool.bump += pool.blockSize;
+			return result;
+		}
+
+		void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+			const size_t size = bytes > alignment ? bytes : alignment;
+			if (size > _options.largest_required_pool_block || alignment > max_align) {
+				_deallocate_large(ptr);
+				return;
+			}
+
+			_pool& pool = _pools[_class_of(size)];
+			pool.free = ::new (ptr) _free_block{ pool.free };
+		}
+
+		bool do_is_equal(const memory_resource& other) const noexcept override {
+			return this == &other;
+		}
+
+		void _refill(_pool& pool) {
+			if (pool.nextBlocks == 0) {
+				const size_t blocks = 1024 / pool.blockSize;
+				pool.nextBlocks = blocks < 8 ? 8 : blocks;
+			}
+			if (pool.nextBlocks > _options.max_blocks_per_chunk)
+				pool.nextBlocks = _options.max_blocks_per_chunk;
+
+			const size_t size = sizeof(_chunk) + pool.nextBlocks * pool.blockSize;
+			_chunk* chunk = ::new (_upstream->allocate(size, alignof(_chunk))) _chunk{ pool.chunks, size };
+			pool.chunks = chunk;
+			pool.bump = reinterpret_cast<unsigned char*>(chunk + 1);
+			pool.bumpEnd = pool.bump + pool.nextBlocks * pool.blockSize;
+			pool.nextBlocks *= 2;
+		}
+
+		void* _allocate_large(size_t bytes, size_t alignment) {
+			const size_t blockAlignment = alignment > alignof(_large_header) ? alignment : alignof(_large_header);
+			const size_t offset = (sizeof(_large_header) + blockAlignment - 1) / blockAlignment * blockAlignment;
+			if (bytes > SIZE_MAX - offset)
+				throw std::bad_alloc();
+
+			unsigned char* block = static_cast<unsigned char*>(_upstream->allocate(bytes + offset, blockAlignment));
+			unsigned char* result = block + offset;
+			_large_header* header = ::new (result - sizeof(_large_header))
+				_large_header{ nullptr, _large, block, bytes + offset, blockAlignment };
+			if (_large)
+				_large->prev = header;
+			_large = header;
+			return result;
+		}
+
+		void _deallocate_large(void* ptr) noexcept {
+			_large_header* header = reinterpret_cast<_large_header*>(static_cast<unsigned char*>(ptr) - sizeof(_large_header));
+			if (header->prev)
+				header->prev->next = header->next;
+			else
+				_large = header->next;
+			if (header->next)
+				header->next->prev = header->prev;
+
+			_upstream->deallocate(header->block, header->size, header->alignment);
+		}
+	private:
+		memory_resource* _upstream;
+		pool_options _options;
+		_pool _pools[_max_pools];
+		unsigned _poolCount = 0;
+		_large_header* _large = nullptr;
+	};
+
+	// unsynchronized_pool_resource behind a mutex.
+	class synchronized_pool_resource : public memory_resource {
+	public:
+		synchronized_pool_resource()
+			: synchronized_pool_resource(pool_options(), get_default_resource()) {}
+
+		explicit synchronized_pool_resource(memory_resource* upstream)
+			: synchronized_pool_resource(pool_options(), upstream) {}
+
+		explicit synchronized_pool_resource(const pool_options& options,
+											memory_resource* upstream = get_default_resource())
+			: _pool(options, upstream) {}
+
+		synchronized_pool_resource(const synchronized_pool_resource&) = delete;
+
+		synchronized_pool_resource& operator=(const synchronized_pool_resource&) = delete;
+
+		void release() {
+			std::lock_guard<std::mutex> lock(_mutex);
+			_pool.release();
+		}
+
+		memory_resource* upstream_resource() const noexcept {
+			return _pool.upstream_resource();
+		}
+
+		pool_options options() const noexcept {
+			return _pool.options();
+		}
+	private:
+		void* do_allocate(size_t bytes, size_t alignment) override {
+			std::lock_guard<std::mutex> lock(_mutex);
+			return _pool.allocate(bytes, alignment);
+		}
+
+		void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+			std::lock_guard<std::mutex> lock(_mutex);
+			_pool.deallocate(ptr, bytes, alignment);
+		}
+
+		bool do_is_equal(const memory_resource& other) const noexcept override {
+			return this == &other;
+		}
+	private:
+		std::mutex _mutex;
+		unsynchronized_pool_resource _pool;
+	};
+}
+
+#endif // LZT_POOL_RESOURCE_H
@@ -0,0 +1,310 @@
+#ifndef LZT_SLAB_ALLOCATOR_H
+#define LZT_SLAB_ALLOCATOR_H
+
+#include <new>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "memory_resource.h"
+#include "../detail/simd.h"
+
+namespace lzt::memory {
+	namespace detail {
+		// Power-of-two size classes from 16 bytes to 16 KiB; anything larger
+		// or over-aligned goes to ::operator new.
+		inline constexpr size_t slab_min_block = 16;
+		inline constexpr size_t slab_max_block = 16 * 1024;
+		inline constexpr unsigned slab_class_count = 11;
+		inline constexpr size_t slab_span_size = 256 * 1024;
+
+		inline unsigned slab_class_of(size_t bytes) noexcept {
+			if (bytes <= slab_min_block)
+				return 0;
+			return lzt::detail::highest_bit(static_cast<unsigned>(bytes - 1)) + 1 - 4;
+		}
+
+		constexpr size_t slab_block_size(unsigned sizeClass) noexcept {
+			return slab_min_block << sizeClass;
+		}
+
+		// Blocks move between a thread and the central lists this many at a
+		// time: about 8 KiB, but never fewer than 4 or more than 64 blocks.
+		constexpr size_t slab_batch_size(unsigned sizeClass) noexcept {
+			const size_t blocks = 8192 / slab_block_size(sizeClass);
+			return blocks < 4 ? 4 : blocks > 64 ? 64 : blocks;
+		}
+
+		// A free block; the first block of a batch also links the next batch.
+		struct slab_block {
+			slab_block* next;
+			slab_block* nextBatch;
+		};
+
+		// Central free lists, one mutex per size class. Created on first use
+		// and deliberately never destroyed, so blocks freed by thread_local
+		// and static destructors at exit still have somewhere to go. Spans are
+		// never returned to the system.
+		class slab_heap {
+		public:
+			static slab_heap& instance() {
+				static slab_heap* heap = new slab_heap();
+				return *heap;
+			}
+
+			slab_block* pop_batch(unsigned sizeClass) {
+				_central& central = _centrals[sizeClass];
+				{
+					std::lock_guard<std::mutex> lock(central.mutex);
+					if (slab_block* batch = central.batches) {
+						central.batches = batch->nextBatch;
+						return batch;
+					}
+				}
+				return _carve(sizeClass);
+			}
+
+			void push_batch(unsigned sizeClass, slab_block* batch) noexcept {
+				_central& central = _centrals[sizeClass];
+				std::lock_guard<std::mutex> lock(central.mutex);
+				batch->nextBatch = central.batches;
+				central.batches = batch;
+			}
+
+			// Single blocks for threads whose cache is already gone.
+			void* allocate_one(unsigned sizeClass) {
+				slab_block* batch = pop_batch(sizeClass);
+				if (batch->next)
+					push_batch(sizeClass, batch->next);
+				return batch;
+			}
+
+			void deallocate_one(void* ptr, unsigned sizeClass) noexcept {
+				push_batch(sizeClass, ::new (ptr) slab_block{ nullptr, nullptr });
+			}
+		private:
+			struct alignas(64) _central {
+				std::mutex mutex;
+				slab_block* batches = nullptr;
+			};
+
+			slab_heap() = default;
+
+			// Splits a new span into batches, keeps the first and publishes
+			// the rest.
+			slab_block* _carve(unsigned sizeClass) {
+				const size_t blockSize = slab_block_size(sizeClass);
+				const size_t batch = slab_batch_size(sizeClass);
+				const size_t batchBytes = blockSize * batch;
+				const size_t batches = slab_span_size / batchBytes > 0 ? slab_span_size / batchBytes : 1;
+				unsigned char* span = static_cast<unsigned char*>(::operator new(batches * batchBytes));
+
+				slab_block* first = nullptr;
+				slab_block* rest = nullptr;
+				for (size_t b = batches; b-- > 0;) {
+					unsigned char* base = span + b * batchBytes;
+					for (size_t i = 0; i < batch; ++i) {
+						slab_block* next = i + 1 < batch ? reinterpret_cast<slab_block*>(base + (i + 1) * blockSize) : nullptr;
+						::new (static_cast<void*>(base + i * blockSize)) slab_block{ next, nullptr };
+					}
+
+					slab_block* head = reinterpret_cast<slab_block*>(base);
+					if (b == 0) {
+						first = head;
+					} else {
+						head->nextBatch = rest;
+						rest = head;
+					}
+				}
+
+				if (rest) {
+					slab_block* last = rest;
+					while (last->nextBatch)
+						last = last->nextBatch;
+
+					_central& central = _centrals[sizeClass];
+					std::lock_guard<std::mutex> lock(central.mutex);
+					last->nextBatch = central.batches;
+					central.batches = rest;
+				}
+				return first;
+			}
+		private:
+			_central _centrals[slab_class_count];
+		};
+
+		// Per-thread free lists. A thread that frees more than two batches of
+		// a class hands one back to the central list, so memory freed on a
+		// different thread than it was allocated on flows back in batches.
+		class slab_thread_cache {
+		public:
+			slab_thread_cache() noexcept = default;
+
+			slab_thread_cache(const slab_thread_cache&) = delete;
+
+			slab_thread_cache& operator=(const slab_thread_cache&) = delete;
+
+			~slab_thread_cache() {
+				for (unsigned i = 0; i < slab_class_count; ++i) {
+					while (_bins[i].head)
+						slab_heap::instance().push_batch(i, _take(i, slab_batch_size(i)));
+				}
+				alive() = false;
+			}
+
+			void* allocate(unsigned sizeClass) {
+				_bin& bin = _bins[sizeClass];
+				if (!bin.head) {
+					// Batches pushed at thread exit may be short, so count.
+					bin.head = slab_heap::instance().pop_batch(sizeClass);
+					bin.count = 0;
+					for (slab_block* block = bin.head; block; block = block->next)
+						++bin.count;
+				}
+
+				slab_block* block = bin.head;
+				bin.head = block->next;
+				--bin.count;
+				return block;
+			}
+
+			void deallocate(void* ptr, unsigned sizeClass) noexcept {
+				_bin& bin = _bins[sizeClass];
+				bin.head = ::new (ptr) slab_block{ bin.head, nullptr };
+
+				const size_t batch = slab_batch_size(sizeClass);
+				if (++bin.count >= 2 * batch)
+					slab_heap::instance().push_batch(sizeClass, _take(sizeClass, batch));
+			}
+
+			// False once this thread's cache has been destroyed.
+			static bool& alive() noexcept {
+				static thread_local bool alive = true;
+				return alive;
+			}
+		private:
+			struct _bin {
+				slab_block* head = nullptr;
+				size_t count = 0;
+			};
+
+			// Detaches up to count blocks from the front of the bin.
+			slab_block* _take(unsigned sizeClass, size_t count) noexcept {
+				_bin& bin = _bins[sizeClass];
+				slab_block* head = bin.head;
+				slab_block* last = head;
+				size_t taken = 1;
+				while (taken < count && last->next) {
+					last = last->next;
+					++taken;
+				}
+
+				bin.head = last->next;
+				bin.count = bin.count > taken ? bin.count - taken : 0;
+				last->next = nullptr;
+				head->nextBatch = nullptr;
+				return head;
+			}
+		private:
+			_bin _bins[slab_class_count];
+		};
+
+		inline slab_thread_cache& slab_cache() {
+			static thread_local slab_thread_cache cache;
+			return cache;
+		}
+	}
+
+	inline void* slab_allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+		if (alignment > detail::slab_min_block)
+			return ::operator new(bytes, std::align_val_t(alignment));
+		if (bytes > detail::slab_max_block)
+			return ::operator new(bytes);
+
+		const unsigned sizeClass = detail::slab_class_of(bytes);
+		if (!detail::slab_thread_cache::alive())
+			return detail::slab_heap::instance().allocate_one(sizeClass);
+		return detail::slab_cache().allocate(sizeClass);
+	}
+
+	// bytes and alignment must match the slab_allocate call.
+	inline void slab_deallocate(void* ptr, size_t bytes, size_t alignment = alignof(std::max_align_t)) noexcept {
+		if (!ptr)
+			return;
+
+		if (alignment > detail::slab_min_block) {
+			::operator delete(ptr, std::align_val_t(alignment));
+			return;
+		}
+		if (bytes > detail::slab_max_block) {
+			::operator delete(ptr);
+			return;
+		}
+
+		const unsigned sizeClass = detail::slab_class_of(bytes);
+		if (!detail::slab_thread_cache::alive()) {
+			detail::slab_heap::instance().deallocate_one(ptr, sizeClass);
+			return;
+		}
+		detail::slab_cache().deallocate(ptr, sizeClass);
+	}
+
+	// Stateless allocator over the slab heap, for any lzt container:
+	// lzt::vector<T, slab_allocator<T>>, basic_string<CharT, Traits, slab_allocator<CharT>>...
+	template<typename T>
+	class slab_allocator {
+	public:
+		using value_type = T;
+		using is_always_equal = std::true_type;
+		using propagate_on_container_move_assignment = std::true_type;
+	public:
+		slab_allocator() noexcept = default;
+
+		template<typename U>
+		slab_allocator(const slab_allocator<U>&) noexcept {}
+
+		[[nodiscard]] T* allocate(size_t count) {
+			if (count > static_cast<size_t>(-1) / sizeof(T))
+				throw std::bad_array_new_length();
+			return static_cast<T*>(slab_allocate(count * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T* ptr, size_t count) noexcept {
+			slab_deallocate(ptr, count * sizeof(T), alignof(T));
+		}
+
+		template<typename U>
+		friend bool operator==(const slab_allocator&, const slab_allocator<U>&) noexcept {
+			return true;
+		}
+
+		template<typename U>
+		friend bool operator!=(const slab_allocator&, const slab_allocator<U>&) noexcept {
+			return false;
+		}
+	};
+
+	namespace detail {
+		class slab_memory_resource final : public memory_resource {
+		private:
+			void* do_allocate(size_t bytes, size_t alignment) override {
+				return slab_allocate(bytes, alignment);
+			}
+
+			void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+				slab_deallocate(ptr, bytes, alignment);
+			}
+
+			bool do_is_equal(const memory_resource& other) const noexcept override {
+				return dynamic_cast<const slab_memory_resource*>(&other) != nullptr;
+			}
+		};
+	}
+
+	// The slab heap as a memory_resource, for polymorphic_allocator.
+	inline memory_resource* slab_resource() noexcept {
+		return detail::immortal_resource<detail::slab_memory_resource>();
+	}
+}
+
+#endif // LZT_SLAB_ALLOCATOR_H
@@ -4,6 +4,8 @@
 
 #include <memory>
 #include <utility>
+#include "compressed_pair.h"
+#include "../type_traits.h"
 
 namespace lzt {
 	template<typename T, typename Deleter = std::default_delete<T>>
@@ -13,24 +15,21 @@ namespace lzt {
 		using element_type = T;
 		using deleter_type = Deleter;
 	public:
-		explicit unique_ptr(pointer ptr = nullptr) noexcept : _pointer(ptr) {}
+		explicit unique_ptr(pointer ptr = nullptr) noexcept : _data(deleter_type(), ptr) {}
+
+		unique_ptr(pointer ptr, deleter_type deleter) noexcept : _data(std::move(deleter), ptr) {}
 
 		unique_ptr(const unique_ptr&) = delete;
 
 		unique_ptr& operator=(const unique_ptr&) = delete;
 
 		unique_ptr(unique_ptr&& other) noexcept
-			: _pointer(other._pointer), _deleter(std::move(other._deleter)) {
-
-			other._pointer = nullptr;
-		}
+			: _data(std::move(other._data.first()), other.release()) {}
 
 		unique_ptr& operator=(unique_ptr&& other) noexcept {
 			if (this != &other) {
-				reset();
-				_pointer = other._pointer;
-				_deleter = std::move(other._deleter);
-				other._pointer = nullptr;
+				reset(other.release());
+				_data.first() = std::move(other._data.first());
 			}
 			return *this;
 		}
@@ -40,48 +39,48 @@ namespace lzt {
 		}
 
 		pointer release() noexcept {
-			pointer oldPointer = _pointer;
-			_pointer = nullptr;
+			pointer oldPointer = _data.second();
+			_data.second() = nullptr;
 			return oldPointer;
 		}
 
 		void reset(pointer ptr = nullptr) noexcept {
-			if (_pointer)
-				_deleter(_pointer);
-			_pointer = ptr;
+			if (_data.second())
+				_data.first()(_data.second());
+			_data.second() = ptr;
 		}
 
 		void swap(unique_ptr& other) noexcept {
-			std::swap(_pointer, other._pointer);
-			std::swap(_deleter, other._deleter);
+			std::swap(_data.first(), other._data.first());
+			std::swap(_data.second(), other._data.second());
 		}
 
 		pointer get() const noexcept {
-			return _pointer;
+			return _data.second();
 		}
 
 		deleter_type& get_deleter() noexcept {
-			return _deleter;
+			return _data.first();
 		}
 
 		const deleter_type& get_deleter() const noexcept {
-			return _deleter;
+			return _data.first();
 		}
 
 		explicit operator bool() const noexcept {
-			return _pointer != nullptr;
+			return _data.second() != nullptr;
 		}
 
 		T& operator*() const noexcept {
-			return *_pointer;
+			return *_data.second();
 		}
 
 		pointer operator->() const noexcept {
-			return _pointer;
+			return _data.second();
 		}
 	private:
-		pointer _pointer = nullptr;
-		deleter_type _deleter;
+		// Stateless deleters take no space.
+		compressed_pair<deleter_type, pointer> _data;
 	};
 
 	template<typename T, typename Deleter>
@@ -91,7 +90,9 @@ namespace lzt {
 		using element_type = T;
 		using deleter_type = Deleter;
 	public:
-		explicit unique_ptr(pointer ptr = nullptr) noexcept : _pointer(ptr) {}
+		explicit unique_ptr(pointer ptr = nullptr) noexcept : _data(deleter_type(), ptr) {}
+
+		unique_ptr(pointer ptr, deleter_type deleter) noexcept : _data(std::move(deleter), ptr) {}
 
 		~unique_ptr() {
 			reset();
@@ -102,48 +103,43 @@ namespace lzt {
 		unique_ptr& operator=(const unique_ptr&) = delete;
 
 		unique_ptr(unique_ptr&& other) noexcept
-			: _pointer(other._pointer), _deleter(std::move(other._deleter)) {
-
-			other._pointer = nullptr;
-		}
+			: _data(std::move(other._data.first()), other.release()) {}
 
 		unique_ptr& operator=(unique_ptr&& other) noexcept {
 			if (this != &other) {
-				reset();
-				_pointer = other._pointer;
-				_deleter = std::move(other._deleter);
-				other._pointer = nullptr;
+				reset(other.release());
+				_data.first() = std::move(other._data.first());
 			}
 			return *this;
 		}
 
 		pointer release() noexcept {
-			pointer oldPointer = _pointer;
-			_pointer = nullptr;
+			pointer oldPointer = _data.second();
+			_data.second() = nullptr;
 			return oldPointer;
 		}
 
 		void reset(pointer ptr = nullptr) noexcept {
-			if (_pointer)
-				_deleter(_pointer);
-			_pointer = ptr;
+			if (_data.second())
+				_data.first()(_data.second());
+			_data.second() = ptr;
 		}
 
 		void swap(unique_ptr& other) noexcept {
-			std::swap(_pointer, other._pointer);
-			std::swap(_deleter, other._deleter);
+			std::swap(_data.first(), other._data.first());
+			std::swap(_data.second(), other._data.second());
 		}
 
 		pointer get() const noexcept {
-			return _pointer;
+			return _data.second();
 		}
 
 		deleter_type& get_deleter() noexcept {
-			return _deleter;
+			return _data.first();
 		}
 
 		const deleter_type& get_deleter() const noexcept {
-			return _deleter;
+			return _data.first();
 		}
 
 		T& operator*() const = delete;
@@ -151,12 +147,19 @@ namespace lzt {
 		pointer operator->() const = delete;
 
 		T& operator[](size_t index) const {
-			return _pointer[index];
+			return _data.second()[index];
 		}
 	private:
-		pointer _pointer = nullptr;
-		deleter_type _deleter;
+		compressed_pair<deleter_type, pointer> _data;
 	};
+
+	template<typename T, typename Deleter>
+	struct is_trivially_relocatable<unique_ptr<T, Deleter>>
+		: std::bool_constant<is_trivially_relocatable_v<Deleter>> {};
+
+	static_assert(sizeof(unique_ptr<int>) == sizeof(int*));
+	static_assert(sizeof(unique_ptr<int[]>) == sizeof(int*));
+	static_assert(sizeof(unique_ptr<int, void(*)(int*)>) == 2 * sizeof(int*));
 }
 
 #endif // LZT_UNIQUE_PTR_H
\ No newline at end of file
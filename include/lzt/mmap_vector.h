@@ -0,0 +1,493 @@
+#ifndef LZT_MMAP_VECTOR_H
+#define LZT_MMAP_VECTOR_H
+
+#if !defined(__unix__) && !defined(__APPLE__)
+#error "lzt::mmap_vector requires POSIX mmap"
+#endif
+
+#include <new>
+#include <limits>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <system_error>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "vector.h"
+
+namespace lzt {
+	enum class mmap_mode {
+		read_only,  // existing file, mapped PROT_READ; mutators throw
+		read_write, // opens the file or creates an empty one
+		truncate    // creates the file or empties an existing one
+	};
+
+	enum class mmap_advice {
+		normal,
+		sequential,
+		random,
+		will_need,
+		dont_need
+	};
+
+	// vector of trivially copyable T stored in a shared file mapping. The
+	// file holds the elements back to back and nothing else, so its length
+	// is the element count. While open, the file is grown with ftruncate
+	// to the capacity; sync(), close() and the destructor cut it back to
+	// size(). Data reaches the page cache at once but is only durable
+	// after sync(). A crash right after sync() reopens with exactly the
+	// synced elements; a crash after the vector has grown again may leave
+	// zero-filled records up to the capacity at the end of the file.
+	// Shrinking a read-only vector only narrows the view; the file is left
+	// alone.
+	template<typename T>
+	class mmap_vector {
+	private:
+		static_assert(std::is_trivially_copyable_v<T>, "mmap_vector<T> requires a trivially copyable T");
+	public:
+		using value_type = T;
+		using size_type = size_t;
+		using difference_type = ptrdiff_t;
+		using pointer = T*;
+		using const_pointer = const T*;
+		using reference = T&;
+		using const_reference = const T&;
+
+		using const_iterator = vector_const_iterator<mmap_vector>;
+		using iterator = vector_iterator<mmap_vector>;
+
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+	public:
+		mmap_vector() noexcept = default;
+
+		explicit mmap_vector(const char* path, mmap_mode mode = mmap_mode::read_write) {
+			open(path, mode);
+		}
+
+		mmap_vector(const mmap_vector&) = delete;
+
+		mmap_vector& operator=(const mmap_vector&) = delete;
+
+		mmap_vector(mmap_vector&& other) noexcept {
+			_steal(other);
+		}
+
+		mmap_vector& operator=(mmap_vector&& other) noexcept {
+			if (this != &other) {
+				_tidy();
+				_steal(other);
+			}
+			return *this;
+		}
+
+		~mmap_vector() {
+			_tidy();
+		}
+
+		void open(const char* path, mmap_mode mode = mmap_mode::read_write) {
+			close();
+
+			const int flags = mode == mmap_mode::read_only ? O_RDONLY
+				: mode == mmap_mode::truncate ? O_RDWR | O_CREAT | O_TRUNC
+				: O_RDWR | O_CREAT;
+			const int fd = ::open(path, flags | O_CLOEXEC, 0644);
+			if (fd < 0)
+				_throw_errno("mmap_vector: open");
+
+			struct stat info;
+			if (::fstat(fd, &info) != 0) {
+				const int error = errno;
+				::close(fd);
+				_throw_errno("mmap_vector: fstat", error);
+			}
+
+			const size_type bytes = static_cast<size_type>(info.st_size);
+			if (bytes % sizeof(T) != 0) {
+				::close(fd);
+				throw std::runtime_error("mmap_vector: file size is not a multiple of sizeof(T)");
+			}
+
+			_fd = fd;
+			_writable = mode != mmap_mode::read_only;
+			if (bytes != 0) {
+				void* data = ::mmap(nullptr, bytes, _writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+				if (data == MAP_FAILED) {
+					const int error = errno;
+					_tidy();
+					_throw_errno("mmap_vector: mmap", error);
+				}
+				_data = static_cast<pointer>(data);
+			}
+			_size = _capacity = bytes / sizeof(T);
+		}
+
+		// Cuts the file back to size() and unmaps it.
+		void close() {
+			if (_fd < 0)
+				return;
+
+			if (_writable && _size != _capacity) {
+				if (::ftruncate(_fd, static_cast<off_t>(_size * sizeof(T))) != 0)
+					_throw_errno("mmap_vector: ftruncate");
+			}
+			_tidy();
+		}
+
+		bool is_open() const noexcept {
+			return _fd >= 0;
+		}
+
+		bool is_read_only() const noexcept {
+			return _fd >= 0 && !_writable;
+		}
+
+		// Trims the file to size(), dropping the spare capacity, then writes
+		// the mapping back and, when waiting, the file length too (fsync).
+		// wait = false schedules the write-back without blocking (MS_ASYNC).
+		void sync(bool wait = true) {
+			if (_writable && _size != _capacity)
+				_remap(_size);
+
+			if (_data && ::msync(_data, _capacity * sizeof(T), wait ? MS_SYNC : MS_ASYNC) != 0)
+				_throw_errno("mmap_vector: msync");
+			if (wait && _writable && ::fsync(_fd) != 0)
+				_throw_errno("mmap_vector: fsync");
+		}
+
+		void advise(mmap_advice advice) {
+			if (!_data)
+				return;
+
+			int flag = MADV_NORMAL;
+			switch (advice) {
+				case mmap_advice::normal:     flag = MADV_NORMAL; break;
+				case mmap_advice::sequential: flag = MADV_SEQUENTIAL; break;
+				case mmap_advice::random:     flag = MADV_RANDOM; break;
+				case mmap_advice::will_need:  flag = MADV_WILLNEED; break;
+				case mmap_advice::dont_need:  flag = MADV_DONTNEED; break;
+			}
+			if (::madvise(_data, _capacity * sizeof(T), flag) != 0)
+				_throw_errno("mmap_vector: madvise");
+		}
+
+		reference at(const size_type index) {
+			if (_size <= index) {
+				throw std::out_of_range("index is out of range");
+			}
+			return _data[index];
+		}
+
+		const_reference at(const size_type index) const {
+			if (_size <= index) {
+				throw std::out_of_range("index is out of range");
+			}
+			return _data[index];
+		}
+
+		reference operator[](const size_type index) noexcept {
+			return _data[index];
+		}
+
+		const_reference operator[](const size_type index) const noexcept {
+			return _data[index];
+		}
+
+		reference front() noexcept {
+			return _data[0];
+		}
+
+		const_reference front() const noexcept {
+			return _data[0];
+		}
+
+		reference back() noexcept {
+			return _data[_size - 1];
+		}
+
+		const_reference back() const noexcept {
+			return _data[_size - 1];
+		}
+
+		pointer data() noexcept {
+			return _data;
+		}
+
+		const_pointer data() const noexcept {
+			return _data;
+		}
+
+		iterator begin() noexcept {
+			return iterator(_data);
+		}
+
+		const_iterator begin() const noexcept {
+			return const_iterator(_data);
+		}
+
+		iterator end() noexcept {
+			return iterator(_data + _size);
+		}
+
+		const_iterator end() const noexcept {
+			return const_iterator(_data + _size);
+		}
+
+		reverse_iterator rbegin() noexcept {
+			return reverse_iterator(end());
+		}
+
+		const_reverse_iterator rbegin() const noexcept {
+			return const_reverse_iterator(end());
+		}
+
+		reverse_iterator rend() noexcept {
+			return reverse_iterator(begin());
+		}
+
+		const_reverse_iterator rend() const noexcept {
+			return const_reverse_iterator(begin());
+		}
+
+		const_iterator cbegin() const noexcept {
+			return begin();
+		}
+
+		const_iterator cend() const noexcept {
+			return end();
+		}
+
+		const_reverse_iterator crbegin() const noexcept {
+			return rbegin();
+		}
+
+		const_reverse_iterator crend() const noexcept {
+			return rend();
+		}
+
+		bool empty() const noexcept {
+			return _size == 0;
+		}
+
+		size_type size() const noexcept {
+			return _size;
+		}
+
+		size_type max_size() const noexcept {
+			return static_cast<size_type>(std::numeric_limits<off_t>::max()) / sizeof(T);
+		}
+
+		void reserve(size_type newCapacity) {
+			if (newCapacity > max_size())
+				throw std::length_error("mmap_vector reserve maximum size exceeded");
+
+			if (_capacity < newCapacity)
+				_remap(newCapacity);
+		}
+
+		size_type capacity() const noexcept {
+			return _capacity;
+		}
+
+		void shrink_to_fit() {
+			if (_writable && _size < _capacity)
+				_remap(_size);
+		}
+
+		void clear() noexcept {
+			_size = 0;
+		}
+
+		void push_back(const T& value) {
+			emplace_back(value);
+		}
+
+		template<typename... Args>
+		reference emplace_back(Args&&... args) {
+			if (_size == _capacity) {
+				const T copy(std::forward<Args>(args)...);
+				_remap(_recommend(_size + 1));
+				return *::new (static_cast<void*>(_data + _size++)) T(copy);
+			}
+
+			_check_writable();
+			return *::new (static_cast<void*>(_data + _size++)) T(std::forward<Args>(args)...);
+		}
+
+		void pop_back() noexcept {
+			--_size;
+		}
+
+		iterator insert(const_iterator pos, const T& value) {
+			if (pos < cbegin() || pos > cend())
+				throw std::out_of_range("mmap_vector insert position out of range");
+
+			const size_type offset = pos - cbegin();
+			const T copy(value);
+			if (_size == _capacity)
+				_remap(_recommend(_size + 1));
+			else
+				_check_writable();
+
+			std::memmove(static_cast<void*>(_data + offset + 1), static_cast<const void*>(_data + offset),
+				(_size - offset) * sizeof(T));
+			::new (static_cast<void*>(_data + offset)) T(copy);
+			++_size;
+			return begin() + offset;
+		}
+
+		iterator erase(const_iterator pos) {
+			return erase(pos, pos + 1);
+		}
+
+		iterator erase(const_iterator first, const_iterator last) {
+			if (first < cbegin() || last > cend() || last < first)
+				throw std::out_of_range("mmap_vector erase iterator out of range");
+
+			_check_writable();
+			const size_type offset = first - cbegin();
+			const size_type count = last - first;
+			std::memmove(static_cast<void*>(_data + offset), static_cast<const void*>(_data + offset + count),
+				(_size - offset - count) * sizeof(T));
+			_size -= count;
+			return begin() + offset;
+		}
+
+		void resize(size_type newSize) {
+			resize(newSize, T());
+		}
+
+		void resize(size_type newSize, const T& value) {
+			if (_size < newSize) {
+				const T copy(value);
+				if (_capacity < newSize)
+					_remap(_recommend(newSize));
+				else
+					_check_writable();
+				std::uninitialized_fill(_data + _size, _data + newSize, copy);
+			}
+			_size = newSize;
+		}
+
+		// New elements keep whatever the file holds there: zero bytes for
+		// space added by ftruncate.
+		void resize_for_overwrite(size_type newSize) {
+			if (_capacity < newSize)
+				_remap(_recommend(newSize));
+			_size = newSize;
+		}
+
+		void swap(mmap_vector& other) noexcept {
+			std::swap(_data, other._data);
+			std::swap(_size, other._size);
+			std::swap(_capacity, other._capacity);
+			std::swap(_fd, other._fd);
+			std::swap(_writable, other._writable);
+		}
+
+		friend void swap(mmap_vector& lhs, mmap_vector& rhs) noexcept {
+			lhs.swap(rhs);
+		}
+	private:
+		[[noreturn]] static void _throw_errno(const char* what, int error = errno) {
+			throw std::system_error(error, std::generic_category(), what);
+		}
+
+		void _check_writable() const {
+			if (_fd < 0 || !_writable)
+				throw std::logic_error("mmap_vector: not open for writing");
+		}
+
+		size_type _recommend(const size_type newSize) const {
+			const size_type maxSize = max_size();
+			if (newSize > maxSize)
+				throw std::length_error("mmap_vector maximum size exceeded");
+
+			if (_capacity > maxSize / 2)
+				return maxSize;
+			return std::max(newSize, _capacity * 2);
+		}
+
+		// Resizes the file to newCapacity elements and maps the new length,
+		// in place or moved with mremap where available.
+		void _remap(const size_type newCapacity) {
+			_check_writable();
+
+			const size_type oldBytes = _capacity * sizeof(T);
+			const size_type newBytes = newCapacity * sizeof(T);
+			if (::ftruncate(_fd, static_cast<off_t>(newBytes)) != 0)
+				_throw_errno("mmap_vector: ftruncate");
+
+			void* data = nullptr;
+			if (newBytes == 0) {
+				if (_data)
+					::munmap(_data, oldBytes);
+			} else if (!_data) {
+				data = ::mmap(nullptr, newBytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+			} else {
+#if defined(MREMAP_MAYMOVE)
+				data = ::mremap(_data, oldBytes, newBytes, MREMAP_MAYMOVE);
+#else
+				data = ::mmap(nullptr, newBytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+				if (data != MAP_FAILED)
+					::munmap(_data, oldBytes);
+#endif
+			}
+
+			if (data == MAP_FAILED) {
+				const int error = errno;
+				(void)::ftruncate(_fd, static_cast<off_t>(oldBytes));
+				_throw_errno("mmap_vector: mmap", error);
+			}
+
+			_data = static_cast<pointer>(data);
+			_capacity = newCapacity;
+		}
+
+		void _steal(mmap_vector& other) noexcept {
+			_data = other._data;
+			_size = other._size;
+			_capacity = other._capacity;
+			_fd = other._fd;
+			_writable = other._writable;
+
+			other._data = nullptr;
+			other._size = 0;
+			other._capacity = 0;
+			other._fd = -1;
+			other._writable = false;
+		}
+
+		// Unmaps and closes without reporting errors; the destructor also
+		// trims the file here.
+		void _tidy() noexcept {
+			if (_fd < 0)
+				return;
+
+			if (_data)
+				::munmap(_data, _capacity * sizeof(T));
+			if (_writable && _size != _capacity)
+				(void)::ftruncate(_fd, static_cast<off_t>(_size * sizeof(T)));
+			::close(_fd);
+
+			_data = nullptr;
+			_size = 0;
+			_capacity = 0;
+			_fd = -1;
+			_writable = false;
+		}
+	private:
+		pointer _data = nullptr;
+		size_type _size = 0;
+		size_type _capacity = 0;
+		int _fd = -1;
+		bool _writable = false;
+	};
+}
+
+#endif // LZT_MMAP_VECTOR_H
@@ -0,0 +1,527 @@
+#ifndef LZT_SMALL_VECTOR_H
+#define LZT_SMALL_VECTOR_H
+
+#include <memory>
+#include <stdexcept>
+#include <initializer_list>
+#include <algorithm>
+#include "hash.h"
+#include "vector.h"
+#include "type_traits.h"
+#include "detail/vector_base.h"
+
+namespace lzt {
+	// vector that keeps up to N elements in an inline buffer and moves to
+	// the heap only when it outgrows it. Moving a small_vector whose
+	// elements are inline moves the elements, so it is never trivially
+	// relocatable and move does not preserve iterators.
+	template<typename T, size_t N, typename Allocator = std::allocator<T>>
+	class small_vector : private detail::vector_base<small_vector<T, N, Allocator>, T, Allocator> {
+	private:
+		using myBase = detail::vector_base<small_vector<T, N, Allocator>, T, Allocator>;
+		using alloc_traits = std::allocator_traits<Allocator>;
+
+		friend myBase;
+
+		static_assert(N > 0, "small_vector<T, N> requires N > 0");
+		static_assert(std::is_same_v<typename alloc_traits::value_type, T>,
+			"small_vector<T, N, Allocator> requires Allocator::value_type to be T");
+		static_assert(std::is_same_v<typename alloc_traits::pointer, T*>,
+			"small_vector<T, N, Allocator> requires an allocator with raw pointers");
+	public:
+		using value_type = T;
+		using allocator_type = Allocator;
+		using size_type = typename alloc_traits::size_type;
+		using difference_type = typename alloc_traits::difference_type;
+		using pointer = T*;
+		using const_pointer = const T*;
+		using reference = T&;
+		using const_reference = const T&;
+
+		using const_iterator = vector_const_iterator<small_vector>;
+		using iterator = vector_iterator<small_vector>;
+
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		static constexpr size_type inline_capacity = N;
+	public:
+		small_vector() noexcept(std::is_nothrow_default_constructible_v<Allocator>) {
+			_data = _inline();
+			_capacity = N;
+		}
+
+		explicit small_vector(const Allocator& alloc) noexcept
+			: myBase(std::in_place, alloc) {
+
+			_data = _inline();
+			_capacity = N;
+		}
+
+		small_vector(std::initializer_list<T> init, const Allocator& alloc = Allocator())
+			: small_vector(alloc) {
+
+			_insert_forward(0, init.begin(), init.size());
+		}
+
+		small_vector(const small_vector& other)
+			: small_vector(other, alloc_traits::select_on_container_copy_construction(other._alloc())) {}
+
+		small_vector(const small_vector& other, const Allocator& alloc)
+			: small_vector(alloc) {
+
+			_insert_forward(0, other._data, other._size);
+		}
+
+		small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+			: myBase(std::in_place, std::move(other._alloc())) {
+
+			_data = _inline();
+			_capacity = N;
+			_take(other);
+		}
+
+		small_vector(small_vector&& other, const Allocator& alloc)
+			: small_vector(alloc) {
+
+			if (alloc_traits::is_always_equal::value || _alloc() == other._alloc())
+				_take(other);
+			else
+				_insert_forward(0, std::make_move_iterator(other._data), other._size);
+		}
+
+		small_vector& operator=(const small_vector& other) {
+			if (this == &other)
+				return *this;
+
+			if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+				if (!alloc_traits::is_always_equal::value && _alloc() != other._alloc())
+					_tidy();
+				_alloc() = other._alloc();
+			}
+
+			_assign_elements(other._data, other._size);
+			return *this;
+		}
+
+		small_vector& operator=(small_vector&& other) noexcept(
+			(alloc_traits::propagate_on_container_move_assignment::value
+			|| alloc_traits::is_always_equal::value) && std::is_nothrow_move_constructible_v<T>) {
+
+			if (this == &other)
+				return *this;
+
+			if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+				_tidy();
+				_alloc() = std::move(other._alloc());
+				_take(other);
+			} else {
+				if (alloc_traits::is_always_equal::value || _alloc() == other._alloc()) {
+					_tidy();
+					_take(other);
+				} else {
+					_assign_elements(std::make_move_iterator(other._data), other._size);
+				}
+			}
+			return *this;
+		}
+
+		~small_vector() {
+			_tidy();
+		}
+
+		constexpr allocator_type get_allocator() const noexcept {
+			return _alloc();
+		}
+
+		constexpr reference at(const size_type index) {
+			if (_size <= index) {
+				throw std::out_of_range("index is out of range");
+			}
+			return _data[index];
+		}
+
+		constexpr const_reference at(const size_type index) const {
+			if (_size <= index) {
+				throw std::out_of_range("index is out of range");
+			}
+			return _data[index];
+		}
+
+		constexpr reference operator[](const size_type index) noexcept {
+			return _data[index];
+		}
+
+		constexpr const_reference operator[](const size_type index) const noexcept {
+			return _data[index];
+		}
+
+		constexpr reference front() noexcept {
+			return _data[0];
+		}
+
+		constexpr const_reference front() const noexcept {
+			return _data[0];
+		}
+
+		constexpr reference back() noexcept {
+			return _data[_size - 1];
+		}
+
+		constexpr const_reference back() const noexcept {
+			return _data[_size - 1];
+		}
+
+		constexpr pointer data() noexcept {
+			return _data;
+		}
+
+		constexpr const_pointer data() const noexcept {
+			return _data;
+		}
+
+		constexpr iterator begin() noexcept {
+			return iterator(_data);
+		}
+
+		constexpr const_iterator begin() const noexcept {
+			return const_iterator(_data);
+		}
+
+		constexpr iterator end() noexcept {
+			return iterator(_data + _size);
+		}
+
+		constexpr const_iterator end() const noexcept {
+			return const_iterator(_data + _size);
+		}
+
+		constexpr reverse_iterator rbegin() noexcept {
+			return reverse_iterator(end());
+		}
+
+		constexpr const_reverse_iterator rbegin() const noexcept {
+			return const_reverse_iterator(end());
+		}
+
+		constexpr reverse_iterator rend() noexcept {
+			return reverse_iterator(begin());
+		}
+
+		constexpr const_reverse_iterator rend() const noexcept {
+			return const_reverse_iterator(begin());
+		}
+
+		constexpr const_iterator cbegin() const noexcept {
+			return begin();
+		}
+
+		constexpr const_iterator cend() const noexcept {
+			return end();
+		}
+
+		constexpr const_reverse_iterator crbegin() const noexcept {
+			return rbegin();
+		}
+
+		constexpr const_reverse_iterator crend() const noexcept {
+			return rend();
+		}
+
+		constexpr bool empty() const noexcept {
+			return _size == 0;
+		}
+
+		constexpr size_type size() const noexcept {
+			return _size;
+		}
+
+		constexpr size_type max_size() const noexcept {
+			return _max_size();
+		}
+
+		constexpr void reserve(size_type newCapacity) {
+			if (newCapacity > max_size())
+				throw std::length_error("small_vector reserve maximum size exceeded");
+
+			if (_capacity < newCapacity)
+				_reallocation(newCapacity);
+		}
+
+		constexpr size_type capacity() const noexcept {
+			return _capacity;
+		}
+
+		// True while the elements live in the inline buffer.
+		constexpr bool is_small() const noexcept {
+			return _data == _inline();
+		}
+
+		// Moves the elements back inline when they fit.
+		constexpr void shrink_to_fit() {
+			if (!is_small() && _size < _capacity)
+				_reallocation(_size);
+		}
+
+		constexpr void clear() noexcept {
+			_clear();
+		}
+
+		iterator insert(const_iterator pos, const T& value) {
+			return emplace(pos, value);
+		}
+
+		iterator insert(const_iterator pos, T&& value) {
+			return emplace(pos, std::move(value));
+		}
+
+		iterator insert(const_iterator pos, size_type count, const T& value) {
+			if (pos < cbegin() || pos > cend())
+				throw std::out_of_range("small_vector insert position out of range");
+
+			const size_type offset = pos - cbegin();
+			if (_is_inside(std::addressof(value))) {
+				const T copy(value);
+				return insert(pos, count, copy);
+			}
+
+			_insert_forward(offset, _repeat_iterator(value), count);
+			return begin() + offset;
+		}
+
+		template<typename InputIt, std::enable_if_t<std::is_convertible_v<
+			typename std::iterator_traits<InputIt>::iterator_category, std::input_iterator_tag>, int> = 0>
+		iterator insert(const_iterator pos, InputIt first, InputIt last) {
+			if (pos < cbegin() || pos > cend())
+				throw std::out_of_range("small_vector insert position is out of range");
+
+			const size_type offset = pos - cbegin();
+			if constexpr (std::is_convertible_v<typename std::iterator_traits<InputIt>::iterator_category,
+				std::forward_iterator_tag>) {
+				_insert_forward(offset, first, static_cast<size_type>(std::distance(first, last)));
+			} else {
+				const size_type oldSize = _size;
+				for (; first != last; ++first)
+					emplace_back(*first);
+				std::rotate(_data + offset, _data + oldSize, _data + _size);
+			}
+			return begin() + offset;
+		}
+
+		iterator insert(const_iterator pos, std::initializer_list<T> ilist) {
+			return insert(pos, ilist.begin(), ilist.end());
+		}
+
+		template<typename Range>
+		iterator insert_range(const_iterator pos, Range&& range) {
+			return insert(pos, std::begin(range), std::end(range));
+		}
+
+		template<typename Range>
+		void append_range(Range&& range) {
+			insert(cend(), std::begin(range), std::end(range));
+		}
+
+		template<typename... Args>
+		iterator emplace(const_iterator pos, Args&&... args) {
+			if (pos < cbegin() || pos > cend())
+				throw std::out_of_range("small_vector emplace position out of range");
+
+			const size_type offset = pos - cbegin();
+			_emplace_at(offset, std::forward<Args>(args)...);
+			return begin() + offset;
+		}
+
+		iterator erase(const_iterator pos) {
+			return erase(pos, pos + 1);
+		}
+
+		iterator erase(const_iterator first, const_iterator last) {
+			if (first < cbegin() || last > cend() || first > last) {
+				throw std::out_of_range("small_vector::erase - invalid range");
+			}
+
+			const size_type offset = first - cbegin();
+			_erase_range(offset, last - first);
+			return begin() + offset;
+		}
+
+		constexpr void push_back(const T& value) {
+			emplace_back(value);
+		}
+
+		constexpr void push_back(T&& value) {
+			emplace_back(std::move(value));
+		}
+
+		template<typename... Args>
+		constexpr reference emplace_back(Args&&... args) {
+			if (_size >= _capacity)
+				return *_reallocation_insert(_size, std::forward<Args>(args)...);
+
+			_construct(_data + _size, std::forward<Args>(args)...);
+			return _data[_size++];
+		}
+
+		constexpr void pop_back() noexcept {
+			--_size;
+			_destroy(_data + _size);
+		}
+
+		constexpr void resize(size_type newSize) {
+			resize(newSize, T());
+		}
+
+		void resize(size_type newSize, const T& value) {
+			_resize(newSize, value);
+		}
+
+		// Like resize, but new elements are default-initialized, so trivial
+		// types are left as they are for the caller to overwrite.
+		void resize_for_overwrite(size_type newSize) {
+			_resize_for_overwrite(newSize);
+		}
+
+		// Heap buffers are exchanged; inline elements are swapped one by one.
+		void swap(small_vector& other) noexcept(std::is_nothrow_move_constructible_v<T>
+			&& std::is_nothrow_swappable_v<T>) {
+			if (this == &other)
+				return;
+
+			if constexpr (alloc_traits::propagate_on_container_swap::value) {
+				using std::swap;
+				swap(_alloc(), other._alloc());
+			}
+
+			if (!is_small() && !other.is_small()) {
+				std::swap(_data, other._data);
+				std::swap(_size, other._size);
+				std::swap(_capacity, other._capacity);
+				return;
+			}
+
+			small_vector temp(std::move(other));
+			other._take(*this);
+			_take(temp);
+		}
+
+		friend void swap(small_vector& lhs, small_vector& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+			lhs.swap(rhs);
+		}
+
+		friend bool operator==(const small_vector& lhs, const small_vector& rhs) {
+			return std::equal(lhs.data(), lhs.data() + lhs.size(), rhs.data(), rhs.data() + rhs.size());
+		}
+
+		friend bool operator!=(const small_vector& lhs, const small_vector& rhs) {
+			return !(lhs == rhs);
+		}
+
+		friend bool operator<(const small_vector& lhs, const small_vector& rhs) {
+			return std::lexicographical_compare(lhs.data(), lhs.data() + lhs.size(), rhs.data(), rhs.data() + rhs.size());
+		}
+
+		friend bool operator>(const small_vector& lhs, const small_vector& rhs) {
+			return rhs < lhs;
+		}
+
+		friend bool operator<=(const small_vector& lhs, const small_vector& rhs) {
+			return !(rhs < lhs);
+		}
+
+		friend bool operator>=(const small_vector& lhs, const small_vector& rhs) {
+			return !(lhs < rhs);
+		}
+	private:
+		static constexpr const char* _max_size_message = "small_vector maximum size exceeded";
+
+		using typename myBase::_repeat_iterator;
+		using myBase::_relocatable;
+		using myBase::_data;
+		using myBase::_size;
+		using myBase::_capacity;
+		using myBase::_alloc;
+		using myBase::_max_size;
+		using myBase::_construct;
+		using myBase::_destroy;
+		using myBase::_relocate;
+		using myBase::_is_inside;
+		using myBase::_clear;
+		using myBase::_tidy;
+		using myBase::_assign_elements;
+		using myBase::_reallocation;
+		using myBase::_reallocation_insert;
+		using myBase::_insert_forward;
+		using myBase::_emplace_at;
+		using myBase::_erase_range;
+		using myBase::_resize;
+		using myBase::_resize_for_overwrite;
+
+		pointer _inline() noexcept {
+			return reinterpret_cast<pointer>(_buffer);
+		}
+
+		const_pointer _inline() const noexcept {
+			return reinterpret_cast<const_pointer>(_buffer);
+		}
+
+		pointer _allocate(const size_type count) {
+			return count <= N ? _inline() : alloc_traits::allocate(_alloc(), count);
+		}
+
+		void _deallocate(pointer ptr, const size_type count) noexcept {
+			if (ptr != _inline())
+				alloc_traits::deallocate(_alloc(), ptr, count);
+		}
+
+		// _reallocation is only called with the elements on the heap or a new
+		// capacity above N, so the old and new buffers never coincide.
+		void _adopt(pointer newData, const size_type newSize, const size_type newCapacity) noexcept {
+			_deallocate(_data, _capacity);
+			_data = newData;
+			_size = newSize;
+			_capacity = newData == _inline() ? N : newCapacity;
+		}
+
+		void _release() noexcept {
+			_deallocate(_data, _capacity);
+			_data = _inline();
+			_capacity = N;
+		}
+
+		// Takes other's elements into an empty, inline *this: a heap buffer
+		// is stolen, inline elements are moved. other is left empty and inline.
+		void _take(small_vector& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+			if (!other.is_small()) {
+				_data = other._data;
+				_size = other._size;
+				_capacity = other._capacity;
+			} else if constexpr (_relocatable) {
+				_relocate(_data, other._data, other._size);
+				_size = other._size;
+			} else {
+				for (; _size < other._size; ++_size)
+					_construct(_data + _size, std::move(other._data[_size]));
+				other.clear();
+			}
+
+			other._data = other._inline();
+			other._size = 0;
+			other._capacity = N;
+		}
+	private:
+		alignas(T) unsigned char _buffer[N * sizeof(T)];
+	};
+}
+
+namespace std {
+	template<typename T, size_t N, typename Allocator>
+	struct hash<lzt::small_vector<T, N, Allocator>> {
+		size_t operator()(const lzt::small_vector<T, N, Allocator>& vec) const
+			noexcept(noexcept(lzt::hash_range(vec.data(), vec.size()))) {
+			return lzt::hash_range(vec.data(), vec.size());
+		}
+	};
+}
+
+#endif // LZT_SMALL_VECTOR_H
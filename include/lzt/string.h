@@ -4,117 +4,22 @@
 
 #include <iostream>
 #include <cctype>
+#include <locale>
 #include <memory>
 #include <cstring>
 #include <stdexcept>
+#include <limits>
 #include <iterator>
 #include <algorithm>
 #include <type_traits>
 #include <initializer_list>
+#include "hash.h"
+#include "type_traits.h"
+#include "string_view.h"
+#include "detail/streambuf.h"
+#include "memory/compressed_pair.h"
 
 namespace lzt {
-    template<typename basic_string>
-    class string_const_iterator {
-    public:
-        using iterator_category = std::random_access_iterator_tag;
-        using value_type = typename basic_string::value_type;
-        using difference_type = typename basic_string::difference_type;
-        using pointer = typename basic_string::const_pointer;
-        using reference = typename basic_string::const_reference;
-    public:
-        constexpr string_const_iterator() noexcept = default;
-
-        constexpr explicit string_const_iterator(pointer ptr) : _pointer(ptr) {}
-
-        constexpr reference operator*() const noexcept {
-            return *_pointer;
-        }
-
-        constexpr pointer operator->() const noexcept {
-            return _pointer;
-        }
-
-        constexpr string_const_iterator& operator++() noexcept {
-            ++_pointer;
-            return *this;
-        }
-
-        constexpr string_const_iterator operator++(int) noexcept {
-            string_const_iterator temp = *this;
-            ++(*this);
-            return temp;
-        }
-
-        constexpr string_const_iterator& operator--() noexcept {
-            --_pointer;
-            return *this;
-        }
-
-        constexpr string_const_iterator operator--(int) noexcept {
-            string_const_iterator temp = *this;
-            --(*this);
-            return temp;
-        }
-
-        constexpr string_const_iterator& operator+=(const difference_type offset) noexcept {
-            _pointer += offset;
-            return *this;
-        }
-
-        constexpr string_const_iterator operator+(const difference_type offset) const noexcept {
-            return string_const_iterator(_pointer + offset);
-        }
-
-        friend constexpr string_const_iterator operator+(
-            const difference_type offset, string_const_iterator next) noexcept {
-            next += offset;
-            return next;
-        }
-
-        constexpr string_const_iterator& operator-=(const difference_type offset) noexcept {
-            _pointer -= offset;
-            return *this;
-        }
-
-        constexpr string_const_iterator operator-(const difference_type offset) const noexcept {
-            return string_const_iterator(_pointer - offset);
-        }
-
-        constexpr difference_type operator-(const string_const_iterator& other) const noexcept {
-            return static_cast<difference_type>(_pointer - other._pointer);
-        }
-
-        constexpr reference operator[](const difference_type offset) const noexcept {
-            return *(*this + offset);
-        }
-
-        constexpr bool operator==(const string_const_iterator& other) const noexcept {
-            return _pointer == other._pointer;
-        }
-
-        constexpr bool operator!=(const string_const_iterator& other) const noexcept {
-            return !(*this == other);
-        }
-
-        constexpr bool operator<(const string_const_iterator& other) const noexcept {
-            return _pointer < other._pointer;
-        }
-
-        constexpr bool operator>(const string_const_iterator& other) const noexcept {
-            return other < *this;
-        }
-
-        constexpr bool operator<=(const string_const_iterator& other) const noexcept {
-            return !(other < *this);
-        }
-
-        constexpr bool operator>=(const string_const_iterator& other) const noexcept {
-            return !(*this < other);
-        }
-    protected:
-        pointer _pointer;
-    };
-
     template<typename basic_string>
     class string_iterator : public string_const_iterator<basic_string> {
     public:
@@ -190,10 +95,40 @@ namespace lzt {
     };
 
     template<typename CharT>
-    class basic_string {
+    struct string_growth_policy {
+        static constexpr size_t next_capacity(size_t capacity, size_t required) noexcept {
+            const size_t geometric = capacity <= (std::numeric_limits<size_t>::max() - 1) / 2
+                ? capacity * 2 + 1
+                : std::numeric_limits<size_t>::max();
+            return required < geometric ? geometric : required;
+        }
+    };
+
+    template<typename CharT, typename Traits = std::char_traits<CharT>,
+             typename Allocator = std::allocator<CharT>>
+    class basic_string : private ebo_storage<Allocator> {
+    private:
+        using myAlloc = ebo_storage<Allocator>;
+        using alloc_traits = std::allocator_traits<Allocator>;
+
+        static_assert(std::is_same_v<typename Traits::char_type, CharT>,
+            "basic_string<CharT, Traits, Allocator> requires Traits::char_type to be CharT");
+        static_assert(std::is_same_v<typename alloc_traits::value_type, CharT>,
+            "basic_string<CharT, Traits, Allocator> requires Allocator::value_type to be CharT");
+        static_assert(std::is_same_v<typename alloc_traits::pointer, CharT*>,
+            "basic_string<CharT, Traits, Allocator> requires an allocator with raw pointers");
+
+        using _view = basic_string_view<CharT, Traits>;
+
+        template<typename T>
+        using _if_view = std::enable_if_t<std::is_convertible_v<const T&, _view>
+            && !std::is_convertible_v<const T&, const CharT*>, int>;
     public:
+        using traits_type = Traits;
         using value_type = CharT;
-        using size_type = size_t;
+        using allocator_type = Allocator;
+        using size_type = typename alloc_traits::size_type;
+        using difference_type = typename alloc_traits::difference_type;
         using pointer = CharT*;
         using const_pointer = const CharT*;
         using reference = CharT&;
@@ -207,174 +142,204 @@ namespace lzt {
     public:
         static constexpr size_type npos = static_cast<size_type>(-1);
 
-        basic_string() noexcept = default;
+        basic_string() noexcept(std::is_nothrow_default_constructible_v<Allocator>) {
+            _become_local();
+        }
 
-        basic_string(size_type count, CharT ch) {
-            if (count == 0) {
-                _size = 0;
-                _capacity = 1;
-                _allocate(_capacity);
-                _elems[0] = CharT();
-                return;
-            }
+        explicit basic_string(const Allocator& alloc) noexcept
+            : myAlloc(std::in_place, alloc) {
+            _become_local();
+        }
 
+        basic_string(size_type count, CharT ch, const Allocator& alloc = Allocator())
+            : myAlloc(std::in_place, alloc) {
+            _allocate(count + 1);
+            Traits::assign(_elems(), count, ch);
             _size = count;
-            _capacity = count + 1;
-            _allocate(_capacity);
-            for (size_type i = 0; i < count; ++i)
-                new (&_elems[i]) CharT(ch);
-            _elems[_size] = CharT();
-        }
-
-        basic_string(const CharT* s, size_type count) {
-            if (!s || count == 0) {
-                _size = 0;
-                _capacity = 1;
-                _allocate(_capacity);
-                _elems[0] = CharT();
-                return;
-            }
+            _elems()[_size] = CharT();
+        }
 
-            _size = count;
-            _capacity = count + 1;
-            _allocate(_capacity);
-            for (size_type i = 0; i < count; ++i)
-                new (&_elems[i]) CharT(s[i]);
-            _elems[_size] = CharT();
-        }
-
-        basic_string(const CharT* s) {
-            if (!s) {
-                _size = 0;
-                _capacity = 1;
-                _allocate(_capacity);
-                _elems[0] = CharT();
-                return;
-            }
+        basic_string(const CharT* s, size_type count, const Allocator& alloc = Allocator())
+            : myAlloc(std::in_place, alloc) {
+            if (!s)
+                count = 0;
 
-            _size = std::char_traits<CharT>::length(s);
-            _capacity = _size + 1;
-            _allocate(_capacity);
-            for (size_t i = 0; i < _size; ++i)
-                new (&_elems[i]) CharT(s[i]);
-            _elems[_size] = CharT();
+            _allocate(count + 1);
+            Traits::copy(_elems(), s, count);
+            _size = count;
+            _elems()[_size] = CharT();
         }
 
+        basic_string(const CharT* s, const Allocator& alloc = Allocator())
+            : basic_string(s, s ? Traits::length(s) : 0, alloc) {}
+
         basic_string(std::nullptr_t) = delete;
 
-        basic_string(const basic_string& other)
-            : _size(other._size), _capacity(other._capacity) {
+        template<typename T, _if_view<T> = 0>
+        explicit basic_string(const T& t, const Allocator& alloc = Allocator())
+            : myAlloc(std::in_place, alloc) {
+            _become_local();
+            const _view sv = t;
+            _assign(sv.data(), sv.size());
+        }
 
-            _allocate(other._capacity);
-            for (size_t i = 0; i < _size; ++i)
-                new (&_elems[i]) CharT(other._elems[i]);
-            _elems[_size] = CharT();
+        template<typename T, _if_view<T> = 0>
+        basic_string(const T& t, size_type pos, size_type count, const Allocator& alloc = Allocator())
+            : myAlloc(std::in_place, alloc) {
+            _become_local();
+            const _view sv = _view(t).substr(pos, count);
+            _assign(sv.data(), sv.size());
         }
 
+        basic_string(const basic_string& other)
+            : basic_string(other.data(), other.size(),
+                alloc_traits::select_on_container_copy_construction(other._alloc())) {}
+
+        basic_string(const basic_string& other, const Allocator& alloc)
+            : basic_string(other.data(), other.size(), alloc) {}
+
         basic_string& operator=(const basic_string& other) {
-            if (this != &other) {
-                basic_string temp(other);
-                swap(temp);
+            if (this == &other)
+                return *this;
+
+            if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+                if (!alloc_traits::is_always_equal::value && _alloc() != other._alloc())
+                    _deallocate();
+                _alloc() = other._alloc();
             }
+
+            _assign(other.data(), other.size());
+            return *this;
+        }
+
+        template<typename T, _if_view<T> = 0>
+        basic_string& operator=(const T& t) {
+            const _view sv = t;
+            _assign(sv.data(), sv.size());
             return *this;
         }
 
         basic_string(basic_string&& other) noexcept
-            : _elems(other._elems), _size(other._size), _capacity(other._capacity) {
+            : myAlloc(std::in_place, std::move(other._alloc())),
+              _bx(other._bx), _size(other._size), _capacity(other._capacity) {
 
-            other._elems = nullptr;
-            other._size = 0;
-            other._capacity = 0;
+            other._become_local();
         }
 
-        basic_string& operator=(basic_string&& other) noexcept {
-            if (this != &other) {
-                swap(other);
+        basic_string(basic_string&& other, const Allocator& alloc)
+            : myAlloc(std::in_place, alloc) {
+
+            if (alloc_traits::is_always_equal::value || _alloc() == other._alloc()) {
+                _steal(other);
+            } else {
+                _become_local();
+                _assign(other.data(), other.size());
             }
-            return *this;
         }
 
-        basic_string(std::initializer_list<CharT> init)
-            : _size(init.size()), _capacity(init.size() + 1) {
+        basic_string& operator=(basic_string&& other) noexcept(
+            alloc_traits::propagate_on_container_move_assignment::value
+            || alloc_traits::is_always_equal::value) {
+
+            if (this == &other)
+                return *this;
 
-            _allocate(_capacity);
-            size_t i = 0;
-            for (auto& ch : init) {
-                new (&_elems[i++]) CharT(ch);
+            if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+                _deallocate();
+                _alloc() = std::move(other._alloc());
+                _steal(other);
+            } else {
+                if (alloc_traits::is_always_equal::value || _alloc() == other._alloc()) {
+                    _deallocate();
+                    _steal(other);
+                } else {
+                    _assign(other.data(), other.size());
+                }
             }
-            _elems[_size] = CharT();
+            return *this;
         }
 
+        basic_string(std::initializer_list<CharT> init, const Allocator& alloc = Allocator())
+            : basic_string(init.begin(), init.size(), alloc) {}
+
         ~basic_string() {
             _deallocate();
         }
 
+        operator _view() const noexcept {
+            return _view(data(), size());
+        }
+
+        constexpr allocator_type get_allocator() const noexcept {
+            return _alloc();
+        }
+
         constexpr reference at(const size_type index) {
             if (size() <= index)
                 throw std::out_of_range("index is out of range");
-            return _elems[index];
+            return _elems()[index];
         }
 
         constexpr const_reference at(const size_type index) const {
             if (size() <= index)
                 throw std::out_of_range("index is out of range");
-            return _elems[index];
+            return _elems()[index];
         }
 
         constexpr reference operator[](const size_type index) noexcept {
-            return _elems[index];
+            return _elems()[index];
         }
 
         constexpr const_reference operator[](const size_type index) const noexcept {
-            return _elems[index];
+            return _elems()[index];
         }
 
         constexpr reference front() noexcept {
-            return _elems[0];
+            return _elems()[0];
         }
 
         constexpr const_reference front() const noexcept {
-            return _elems[0];
+            return _elems()[0];
         }
 
         constexpr reference back() noexcept {
-            return _elems[_size - 1];
+            return _elems()[_size - 1];
         }
 
         constexpr const_reference back() const noexcept {
-            return _elems[_size - 1];
+            return _elems()[_size - 1];
         }
 
         constexpr pointer data() noexcept {
-            return _elems;
+            return _elems();
         }
 
         constexpr const_pointer data() const noexcept {
-            return _elems;
+            return _elems();
         }
 
         constexpr pointer c_str() noexcept {
-            return _elems;
+            return _elems();
         }
 
         constexpr const_pointer c_str() const noexcept {
-            return _elems;
+            return _elems();
         }
 
         constexpr iterator begin() noexcept {
-            return iterator(_elems);
+            return iterator(_elems());
         }
 
         constexpr const_iterator begin() const noexcept {
-            return const_iterator(_elems);
+            return const_iterator(_elems());
         }
 
         constexpr iterator end() noexcept {
-            return iterator(_elems + _size);
+            return iterator(_elems() + _size);
         }
 
         constexpr const_iterator end() const noexcept {
-            return const_iterator(_elems + _size);
+            return const_iterator(_elems() + _size);
         }
 
         constexpr reverse_iterator rbegin() noexcept {
@@ -422,11 +387,12 @@ namespace lzt {
         }
 
         constexpr size_type max_size() const noexcept {
-            return std::numeric_limits<size_t>::max();
+            return std::min<size_type>(alloc_traits::max_size(_alloc()),
+                std::numeric_limits<difference_type>::max()) - 1;
         }
 
         void reserve(size_type newCapacity) {
-            if (capacity() - 1 < newCapacity)
+            if (capacity() < newCapacity + 1)
                 _reallocate(newCapacity + 1);
         }
 
@@ -435,42 +401,25 @@ namespace lzt {
         }
 
         void shrink_to_fit() {
-            if (size() == 0)
-                _reallocate(1);
-
-            if (size() < capacity())
+            if (size() + 1 < capacity())
                 _reallocate(size() + 1);
         }
 
         constexpr void clear() {
-            for (size_t i = 0; i < size(); ++i)
-                _elems[i].~CharT();
             _size = 0;
-            _elems[0] = CharT();
+            _elems()[0] = CharT();
         }
 
         basic_string& insert(const size_type index, const size_type count, CharT ch) {
             if (index > size())
                 throw std::out_of_range("insert: index is out of range");
 
-            if(size() + count > capacity())
-                reserve(size() + count);
-
-            for (size_type i = size(); i > index; --i) {
-                new (&_elems[i + count - 1]) CharT(std::move(_elems[i - 1]));
-                _elems[i - 1].~CharT();
-            }
-
-            for (size_type i = 0; i < count; ++i)
-                new (&_elems[index + i]) CharT(ch);
-
-            _size += count;
-            _elems[_size] = CharT();
+            Traits::assign(_replace_gap(index, 0, count), count, ch);
             return *this;
         }
 
         basic_string& insert(const size_type index, const CharT* s) {
-            size_type len_s = std::char_traits<CharT>::length(s);
+            size_type len_s = Traits::length(s);
             return insert(index, s, len_s);
         }
 
@@ -478,19 +427,10 @@ namespace lzt {
             if (index > size())
                 throw std::out_of_range("insert: index is out of range");
 
-            if (size() + count > capacity())
-                reserve(size() + count);
-
-            for (size_type i = size(); i > index; --i) {
-                new (&_elems[i + count - 1]) CharT(std::move(_elems[i - 1]));
-                _elems[i - 1].~CharT();
-            }
-
-            for (size_type i = 0; i < count; ++i)
-                new (&_elems[index + i]) CharT(s[i]);
+            if (_is_inside(s))
+                return insert(index, basic_string(s, count, _alloc()));
 
-            _size += count;
-            _elems[_size] = CharT();
+            Traits::copy(_replace_gap(index, 0, count), s, count);
             return *this;
         }
 
@@ -507,6 +447,19 @@ namespace lzt {
             return insert(index, str.data() + s_index, real_count);
         }
 
+        template<typename T, _if_view<T> = 0>
+        basic_string& insert(const size_type index, const T& t) {
+            const _view sv = t;
+            return insert(index, sv.data(), sv.size());
+        }
+
+        template<typename T, _if_view<T> = 0>
+        basic_string& insert(const size_type index, const T& t,
+                             const size_type s_index, const size_type count = npos) {
+            const _view sv = _view(t).substr(s_index, count);
+            return insert(index, sv.data(), sv.size());
+        }
+
         iterator insert(const_iterator pos, CharT ch) {
             size_type index = pos - cbegin();
             insert(index, 1, ch);
@@ -519,26 +472,31 @@ namespace lzt {
             return begin() + index;
         }
 
-        template<typename InputIt>
+        template<typename InputIt, std::enable_if_t<std::is_convertible_v<
+            typename std::iterator_traits<InputIt>::iterator_category, std::input_iterator_tag>, int> = 0>
         iterator insert(const_iterator pos, InputIt first, InputIt last) {
-            size_type index = pos - cbegin();
-            if (first == last) return begin() + index;
-
-            size_type count = std::distance(first, last);
-            
-            if (size() + count > capacity())
-                reserve(size() + count);
+            const size_type index = pos - cbegin();
+            if constexpr (std::is_convertible_v<typename std::iterator_traits<InputIt>::iterator_category,
+                std::forward_iterator_tag>) {
+                const size_type count = static_cast<size_type>(std::distance(first, last));
+                if constexpr (std::is_convertible_v<InputIt, const_iterator>
+                    || std::is_convertible_v<InputIt, const CharT*>) {
+                    if (count != 0 && _is_inside(&*first)) {
+                        const basic_string copy(&*first, count, _alloc());
+                        return insert(pos, copy.begin(), copy.end());
+                    }
+                }
 
-            for (size_type i = size(); i > index; --i) {
-                new (&_elems[i + count - 1]) CharT(std::move(_elems[i - 1]));
-                _elems[i - 1].~CharT();
+                CharT* gap = _replace_gap(index, 0, count);
+                for (; first != last; ++first, ++gap)
+                    Traits::assign(*gap, *first);
+            } else {
+                // Single pass: the length is only known once the range is read.
+                basic_string temp(_alloc());
+                for (; first != last; ++first)
+                    temp.push_back(*first);
+                return insert(pos, temp.cbegin(), temp.cend());
             }
-
-            for (size_type i = 0; first != last; ++first, ++i)
-                new (&_elems[index + i]) CharT(*first);
-
-            _size += count;
-            _elems[_size] = CharT();
             return begin() + index;
         }
 
@@ -553,13 +511,10 @@ namespace lzt {
             size_type real_count = std::min(count, size() - index);
             if (real_count == 0) return *this;
             
-            for (size_type i = index + real_count; i < size(); ++i) {
-                new (&_elems[i - real_count]) CharT(std::move(_elems[i]));
-                _elems[i].~CharT();
-            }
+            Traits::move(_elems() + index, _elems() + index + real_count, size() - index - real_count);
 
             _size -= real_count;
-            _elems[_size] = CharT();
+            _elems()[_size] = CharT();
             return *this;
         }
 
@@ -582,57 +537,50 @@ namespace lzt {
             return begin() + index;
         }
 
-        void push_back(const CharT& ch) noexcept {
-            if (size() == capacity())
-                _reallocate(capacity() * 2 + 1);
+        void push_back(const CharT& ch) {
+            _grow_to(size() + 1);
 
-            new (&_elems[_size++]) CharT(ch);
-            _elems[_size] = CharT();
+            Traits::assign(_elems()[_size++], ch);
+            _elems()[_size] = CharT();
         }
 
-        void push_back(CharT&& ch) noexcept {
-            if (size() == capacity())
-                _reallocate(capacity() * 2 + 1);
+        void push_back(CharT&& ch) {
+            _grow_to(size() + 1);
 
-            new (&_elems[_size++]) CharT(std::move(ch));
-            _elems[_size] = CharT();
+            Traits::assign(_elems()[_size++], ch);
+            _elems()[_size] = CharT();
         }
 
         void pop_back() noexcept {
             --_size;
-            _elems[_size].~CharT();
-            _elems[_size] = CharT();
+            _elems()[_size] = CharT();
         }
 
         basic_string& append(size_type count, CharT ch) {
             if (count == 0) return *this;
-            
-            reserve(size() + count);
-            for (size_type i = 0; i < count; ++i)
-                new (&_elems[_size++]) CharT(ch);
-            _elems[_size] = CharT();
+
+            _grow_to(size() + count);
+            Traits::assign(_elems() + _size, count, ch);
+            _size += count;
+            _elems()[_size] = CharT();
             return *this;
         }
 
         basic_string& append(const CharT* s, size_type count) {
             if (count == 0) return *this;
 
-            reserve(size() + count);
-            for (size_type i = 0; i < count; ++i)
-                new (&_elems[_size++]) CharT(s[i]);
-            _elems[_size] = CharT();
+            if (_is_inside(s) && size() + count + 1 > capacity())
+                return append(basic_string(s, count, _alloc()));
+
+            _grow_to(size() + count);
+            Traits::copy(_elems() + _size, s, count);
+            _size += count;
+            _elems()[_size] = CharT();
             return *this;
         }
 
         basic_string& append(const CharT* s) {
-            size_type len_s = std::char_traits<CharT>::length(s);
-            if (len_s == 0) return *this;
-
-            reserve(_size + len_s);
-            for (size_type i = 0; i < len_s; ++i)
-                new (&_elems[_size++]) CharT(s[i]);
-            _elems[_size] = CharT();
-            return *this;
+            return append(s, Traits::length(s));
         }
 
         basic_string& append(const basic_string& str) {
@@ -647,6 +595,18 @@ namespace lzt {
             return append(str.c_str() + pos, actual_count);
         }
 
+        template<typename T, _if_view<T> = 0>
+        basic_string& append(const T& t) {
+            const _view sv = t;
+            return append(sv.data(), sv.size());
+        }
+
+        template<typename T, _if_view<T> = 0>
+        basic_string& append(const T& t, size_type pos, size_type count = npos) {
+            const _view sv = _view(t).substr(pos, count);
+            return append(sv.data(), sv.size());
+        }
+
         basic_string& append(std::initializer_list<CharT> ilist) {
             return append(ilist.begin(), ilist.size());
         }
@@ -663,86 +623,95 @@ namespace lzt {
             return append(s);
         }
 
+        template<typename T, _if_view<T> = 0>
+        basic_string& operator+=(const T& t) {
+            return append(t);
+        }
+
         basic_string& operator+=(std::initializer_list<CharT> ilist) {
             return append(ilist.begin(), ilist.size());
         }
 
         basic_string& replace(const size_type pos, const size_type count,
                               const basic_string& str) {
-            erase(pos, count);
-            insert(pos, str);
-            return *this;
+            return replace(pos, count, str.data(), str.size());
         }
 
         basic_string& replace(const_iterator first, const_iterator last,
                               const basic_string& str) {
-            size_type index = first - cbegin();
-            size_type count = last - first;
-
-            erase(index, count);
-            insert(index, str);
-            return *this;
+            return replace(first - cbegin(), last - first, str.data(), str.size());
         }
 
         basic_string& replace(const size_type pos1, const size_type count1,
                               const basic_string& str,
                               const size_type pos2, const size_type count2 = npos) {
             if (pos2 > str.size())
-                throw std::out_of_range("replce: pos2 is out of range");
+                throw std::out_of_range("replace: pos2 is out of range");
 
             size_type real_count2 = std::min(count2, str.size() - pos2);
-            erase(pos1, count1);
-            insert(pos1, str.data() + pos2, real_count2);
-            return *this;
+            return replace(pos1, count1, str.data() + pos2, real_count2);
         }
 
         basic_string& replace(const size_type pos, const size_type count1,
                               const CharT* s, size_type count2) {
-            erase(pos, count1);
-            insert(pos, s, count2);
+            if (pos > size())
+                throw std::out_of_range("replace: pos is out of range");
+
+            if (_is_inside(s))
+                return replace(pos, count1, basic_string(s, count2, _alloc()));
+
+            const size_type real_count1 = std::min(count1, size() - pos);
+            Traits::copy(_replace_gap(pos, real_count1, count2), s, count2);
             return *this;
         }
 
         basic_string& replace(const_iterator first, const_iterator last,
                               const CharT* s, const size_type count2) {
-            size_type pos = first - cbegin();
-            size_type count1 = last - first;
-            erase(pos, count1);
-            insert(pos, s, count2);
-            return* this;
+            return replace(first - cbegin(), last - first, s, count2);
         }
 
         basic_string& replace(const size_type pos, const size_type count,
                               const CharT* s) {
-            erase(pos, count);
-            insert(pos, s, count);
-            return *this;
+            return replace(pos, count, s, Traits::length(s));
         }
 
         basic_string& replace(const_iterator first, const_iterator last,
                               const CharT* s) {
-            size_type pos = first - cbegin();
-            size_type count = last - first;
-            size_type len_s = std::char_traits<CharT>::length(s);
-            erase(pos, count);
-            insert(pos, s, len_s);
-            return *this;
+            return replace(first - cbegin(), last - first, s, Traits::length(s));
         }
 
         basic_string& replace(const size_type pos, const size_type count1,
                               const size_type count2, CharT ch) {
-            erase(pos, count1);
-            insert(pos, count2, ch);
+            if (pos > size())
+                throw std::out_of_range("replace: pos is out of range");
+
+            const size_type real_count1 = std::min(count1, size() - pos);
+            Traits::assign(_replace_gap(pos, real_count1, count2), count2, ch);
             return *this;
         }
 
         basic_string& replace(const_iterator first, const_iterator last,
                               size_type count2, CharT ch) {
-            size_type pos = first - cbegin();
-            size_type count1 = last - first;
-            erase(pos, count1);
-            insert(pos, count2, ch);
-            return *this;
+            return replace(first - cbegin(), last - first, count2, ch);
+        }
+
+        template<typename T, _if_view<T> = 0>
+        basic_string& replace(const size_type pos, const size_type count, const T& t) {
+            const _view sv = t;
+            return replace(pos, count, sv.data(), sv.size());
+        }
+
+        template<typename T, _if_view<T> = 0>
+        basic_string& replace(const_iterator first, const_iterator last, const T& t) {
+            const _view sv = t;
+            return replace(first, last, sv.data(), sv.size());
+        }
+
+        template<typename T, _if_view<T> = 0>
+        basic_string& replace(const size_type pos1, const size_type count1, const T& t,
+                              const size_type pos2, const size_type count2 = npos) {
+            const _view sv = _view(t).substr(pos2, count2);
+            return replace(pos1, count1, sv.data(), sv.size());
         }
 
         template< class InputIt >
@@ -750,18 +719,32 @@ namespace lzt {
                               InputIt first2, InputIt last2) {
             size_type pos = first - cbegin();
             size_type count1 = last - first;
-            erase(pos, count1);
-            insert(pos, first2, last2);
+            size_type count2 = std::distance(first2, last2);
+
+            if constexpr (std::is_convertible_v<InputIt, const_iterator>
+                || std::is_convertible_v<InputIt, const CharT*>) {
+                if (count2 != 0 && _is_inside(&*first2))
+                    return replace(first, last, basic_string(&*first2, count2, _alloc()));
+            }
+
+            CharT* gap = _replace_gap(pos, count1, count2);
+            for (size_type i = 0; first2 != last2; ++first2, ++i)
+                Traits::assign(gap[i], *first2);
             return *this;
         }
 
         basic_string& replace(const_iterator first, const_iterator last,
                               std::initializer_list<CharT> ilist) {
-            size_type pos = first - cbegin();
-            size_type count = last - first;
-            erase(pos, count);
-            insert(pos, ilist);
-            return *this;
+            return replace(first, last, ilist.begin(), ilist.size());
+        }
+
+        basic_string& replace_all(_view from, _view to) {
+            const std::pair<_view, _view> pattern(from, to);
+            return _replace_all(&pattern, 1);
+        }
+
+        basic_string& replace_all(std::initializer_list<std::pair<_view, _view>> patterns) {
+            return _replace_all(patterns.begin(), patterns.size());
         }
 
         size_type copy(CharT* dest, size_type count, size_type pos = 0) const {
@@ -769,9 +752,7 @@ namespace lzt {
                 throw std::out_of_range("copy: pos is out of range");
 
             size_type real_count = std::min(count, size() - pos);
-
-            for (size_type i = 0; i < real_count; ++i) 
-                dest[i] = _elems[pos + i];
+            Traits::copy(dest, data() + pos, real_count);
 
             return real_count;
         }
@@ -785,352 +766,170 @@ namespace lzt {
                 throw std::length_error("basic_string::resize");
 
             if (_size < newSize) {
-                reserve(newSize + 1);
-
-                for (size_t i = _size; i < newSize; ++i)
-                    new (&_elems[i]) CharT(ch);
-            }
-            else if (_size > newSize) {
-                for (size_t i = newSize; i < _size; ++i)
-                    _elems[i].~CharT();
+                _grow_to(newSize);
+                Traits::assign(_elems() + _size, newSize - _size, ch);
             }
             _size = newSize;
-            _elems[_size] = CharT();
+            _elems()[_size] = CharT();
+        }
+
+        // op(data(), count) writes straight into the buffer and returns the
+        // final length, at most count. Characters past the old size are
+        // not initialized beforehand.
+        template<typename Operation>
+        void resize_and_overwrite(size_type count, Operation op) {
+            _grow_to(count);
+
+            const size_type newSize = static_cast<size_type>(std::move(op)(_elems(), count));
+            _size = newSize;
+            _elems()[_size] = CharT();
         }
 
         void swap(basic_string& other) noexcept {
-            std::swap(_elems, other._elems);
+            if constexpr (alloc_traits::propagate_on_container_swap::value) {
+                using std::swap;
+                swap(_alloc(), other._alloc());
+            }
+            std::swap(_bx, other._bx);
             std::swap(_size, other._size);
             std::swap(_capacity, other._capacity);
         }
 
-        size_type find(const basic_string& str, size_type pos = 0) const {
-            if (pos > size())
-                return npos;
-
-            if (str.size() == 0)
-                return pos;
-
-            return find(str.c_str(), pos, str.size());
+        size_type find(const basic_string& str, size_type pos = 0) const noexcept {
+            return find(str.data(), pos, str.size());
         }
 
-        size_type find(const CharT* s, size_type pos, size_type count) const {
-            if (pos > size())
-                return npos;
-            size_type len_s = std::char_traits<CharT>::length(s);
-            size_type search_len = (count < len_s) ? count : len_s;
-
-            if (search_len == 0)
-                return pos;
-
-            if (pos + search_len > size())
-                return npos;
-
-            for (size_type i = pos; i <= size() - search_len; ++i) {
-                if (std::char_traits<CharT>::compare(_elems + i, s, search_len) == 0)
-                    return i;
-            }
-            return npos;
+        template<typename T, _if_view<T> = 0>
+        size_type find(const T& t, size_type pos = 0) const noexcept(std::is_nothrow_constructible_v<_view, const T&>) {
+            const _view sv = t;
+            return find(sv.data(), pos, sv.size());
         }
 
-        size_type find(const CharT* s, size_type pos = 0) const {
-            if (pos > size())
-                return npos;
-
-            size_type len_s = std::char_traits<CharT>::length(s);
-            if (len_s == 0)
-                return pos;
-
-            for (size_type i = pos; i < size(); ++i) {
-                if (std::char_traits<CharT>::compare(_elems + i, s, len_s) == 0)
-                    return i;
-            }
-            return npos;
+        size_type find(const CharT* s, size_type pos, size_type count) const noexcept {
+            return detail::search<Traits>(data(), size(), pos, s, count);
         }
 
-        size_type find(CharT ch, size_type pos = 0) const {
-            if (pos > size())
-                return npos;
-
-            for (size_type i = pos; i < size(); ++i) {
-                if (_elems[i] == ch)
-                    return i;
-            }
-            return npos;
+        size_type find(const CharT* s, size_type pos = 0) const noexcept {
+            return find(s, pos, Traits::length(s));
         }
 
-        size_type rfind(const basic_string& str, size_type pos = npos) const {
-            if (str.size() == 0)
-                return std::min(pos, size());
-
-            return rfind(str.c_str(), pos, str.size());
+        size_type find(CharT ch, size_type pos = 0) const noexcept {
+            return detail::find_char<Traits>(data(), size(), pos, ch);
         }
 
-        size_type rfind(const CharT* s, size_type pos, size_type count) const {
-            size_type len_s = std::char_traits<CharT>::length(s);
-            size_type search_len = (count < len_s) ? count : len_s;
-
-            if (search_len == 0)
-                return std::min(pos, size());
-
-            if (search_len > size())
-                return npos;
-
-            size_type start = (pos == npos || pos > size() - search_len) ? size() - search_len : pos;
-            for (size_type i = start; i != npos; --i) {
-                if (std::char_traits<CharT>::compare(_elems + i, s, search_len) == 0) {
-                    return i;
-                }
-                if (i == 0) break;
-            }
-            return npos;
+        size_type rfind(const basic_string& str, size_type pos = npos) const noexcept {
+            return rfind(str.data(), pos, str.size());
         }
 
-        size_type rfind(const CharT* s, size_type pos = npos) const {
-            size_type len_s = std::char_traits<CharT>::length(s);
-            if (len_s == 0)
-                return std::min(pos, size());
-
-            if (len_s > size())
-                return npos;
-            
-            size_type start = (pos == npos || pos > size() - len_s) ? size() - len_s : pos;
-            for (size_type i = start; i != npos; --i) {
-                if (std::char_traits<CharT>::compare(_elems + i, s, len_s) == 0)
-                    return i;
-
-                if (i == 0) break;
-            }
-            return npos;
+        template<typename T, _if_view<T> = 0>
+        size_type rfind(const T& t, size_type pos = npos) const noexcept(std::is_nothrow_constructible_v<_view, const T&>) {
+            const _view sv = t;
+            return rfind(sv.data(), pos, sv.size());
         }
 
-        size_type rfind(CharT ch, size_type pos = npos) const {
-            if (size() == 0)
-                return npos;
-
-            size_type start = (pos >= size()) ? size() - 1 : pos;
-            for (size_type i = start; i != npos; --i) {
-                if (_elems[i] == ch)
-                    return i;
-                if (i == 0) break;
-            }
-            return npos;
+        size_type rfind(const CharT* s, size_type pos, size_type count) const noexcept {
+            return detail::reverse_search<Traits>(data(), size(), pos, s, count);
         }
 
-        size_type find_first_of(const basic_string& str, size_type pos = 0) const {
-            return find_first_of(str.c_str(), pos, str.size());
+        size_type rfind(const CharT* s, size_type pos = npos) const noexcept {
+            return rfind(s, pos, Traits::length(s));
         }
 
-        size_type find_first_of(const CharT* s, size_type pos, size_type count) const {
-            if (count == 0 || pos > size())
-                return npos;
-
-            for (size_type i = pos; i < size(); ++i) {
-                for (size_type j = 0; j < count; ++j) {
-                    if (_elems[i] == s[j])
-                        return i;
-                }
-            }
-            return npos;
+        size_type rfind(CharT ch, size_type pos = npos) const noexcept {
+            return detail::rfind_char<Traits>(data(), size(), pos, ch);
         }
 
-        size_type find_first_of(const CharT* s, size_type pos = 0) const {
-            if (pos > size())
-                return npos;
-
-            size_type len_s = std::char_traits<CharT>::length(s);
-            if (len_s == 0)
-                return npos;
-
-            for (size_type i = pos; i < size(); ++i) {
-                for (size_type j = 0; j < len_s; ++j) {
-                    if (_elems[i] == s[j])
-                        return i;
-                }
-            }
-            return npos;
+        size_type find_first_of(const basic_string& str, size_type pos = 0) const noexcept {
+            return find_first_of(str.data(), pos, str.size());
         }
 
-        size_type find_first_of(CharT ch, size_type pos = 0) const {
-            if (pos > size())
-                return npos;
-
-            for (size_type i = pos; i < size(); ++i) {
-                if (_elems[i] == ch)
-                    return i;
-            }
-            return npos;
+        template<typename T, _if_view<T> = 0>
+        size_type find_first_of(const T& t, size_type pos = 0) const noexcept(std::is_nothrow_constructible_v<_view, const T&>) {
+            const _view sv = t;
+            return find_first_of(sv.data(), pos, sv.size());
         }
 
-        size_type find_first_not_of(const basic_string& str, size_type pos = 0) const {
-            return find_first_not_of(str.c_str(), pos, str.size());
+        size_type find_first_of(const CharT* s, size_type pos, size_type count) const noexcept {
+            return detail::find_in_set<Traits, true>(data(), size(), pos, s, count);
         }
 
-        size_type find_first_not_of(const CharT* s, size_type pos, size_type count) const {
-            if (pos > size())
-                return npos;
-            
-            for (size_type i = pos; i < size(); ++i) {
-                bool found = false;
-                for (size_type j = 0; j < count; ++j) {
-                    if (_elems[i] == s[j]) {
-                        found = true;
-                        break;
-                    }
-                }
-                if (!found) return i;
-            }
-            return npos;
+        size_type find_first_of(const CharT* s, size_type pos = 0) const noexcept {
+            return find_first_of(s, pos, Traits::length(s));
         }
 
-        size_type find_first_not_of(const CharT* s, size_type pos = 0) const {
-            if (pos > size())
-                return npos;
-
-            size_type len_s = std::char_traits<CharT>::length(s);
-            if (len_s == 0)
-                return pos;
-
-            for (size_type i = pos; i < size(); ++i) {
-                bool found = false;
-                for (size_type j = 0; j < len_s; ++j) {
-                    if (_elems[i] == s[j]) {
-                        found = true;
-                        break;
-                    }
-                }
-                if (!found) return i;
-            }
-            return npos;
+        size_type find_first_of(CharT ch, size_type pos = 0) const noexcept {
+            return detail::find_char<Traits>(data(), size(), pos, ch);
         }
 
-        size_type find_first_not_of(CharT ch, size_type pos = 0) const {
-            if (pos > size())
-                return npos;
-
-            for (size_type i = pos; i < size(); ++i) {
-                if (_elems[i] != ch)
-                    return i;
-            }
-            return npos;
+        size_type find_first_not_of(const basic_string& str, size_type pos = 0) const noexcept {
+            return find_first_not_of(str.data(), pos, str.size());
         }
 
-        size_type find_last_of(const basic_string& str, size_type pos = npos) const {
-            return find_last_of(str.c_str(), pos, str.size());
+        template<typename T, _if_view<T> = 0>
+        size_type find_first_not_of(const T& t, size_type pos = 0) const noexcept(std::is_nothrow_constructible_v<_view, const T&>) {
+            const _view sv = t;
+            return find_first_not_of(sv.data(), pos, sv.size());
         }
 
-        size_type find_last_of(const CharT* s, size_type pos, size_type count) const {
-            if (size() == 0)
-                return npos;
-
-            if (count == 0)
-                return npos;
-
-            size_type start = (pos >= size()) ? size() - 1 : pos;
-            for (size_type i = start; i != npos; --i) {
-                for (size_type j = 0; j < count; ++j) {
-                    if (_elems[i] == s[j])
-                        return i;
-                }
-                if (i == 0) break;
-            }
-            return npos;
+        size_type find_first_not_of(const CharT* s, size_type pos, size_type count) const noexcept {
+            return detail::find_in_set<Traits, false>(data(), size(), pos, s, count);
         }
 
-        size_type find_last_of(const CharT* s, size_type pos = npos) const {
-            if (size() == 0)
-                return npos;
-
-            size_type len_s = std::char_traits<CharT>::length(s);
-            if (len_s == 0)
-                return npos;
+        size_type find_first_not_of(const CharT* s, size_type pos = 0) const noexcept {
+            return find_first_not_of(s, pos, Traits::length(s));
+        }
 
-            size_type start = (pos >= size()) ? size() - 1 : pos;
-            for (size_type i = start; i != npos; --i) {
-                for (size_type j = 0; j < len_s; ++j) {
-                    if (_elems[i] == s[j])
-                        return i;
-                }
-                if (i == 0) break;
-            }
-            return npos;
+        size_type find_first_not_of(CharT ch, size_type pos = 0) const noexcept {
+            return find_first_not_of(&ch, pos, 1);
         }
 
-        size_type find_last_of(CharT ch, size_type pos = npos) const {
-            if (size() == 0)
-                return npos;
+        size_type find_last_of(const basic_string& str, size_type pos = npos) const noexcept {
+            return find_last_of(str.data(), pos, str.size());
+        }
 
-            size_type start = (pos >= size()) ? size() - 1 : pos;
-            for (size_type i = start; i != npos; --i) {
-                if (_elems[i] == ch)
-                    return i;
-                if (i == 0) break;
-            }
-            return npos;
+        template<typename T, _if_view<T> = 0>
+        size_type find_last_of(const T& t, size_type pos = npos) const noexcept(std::is_nothrow_constructible_v<_view, const T&>) {
+            const _view sv = t;
+            return find_last_of(sv.data(), pos, sv.size());
         }
 
-        size_type find_last_not_of(const basic_string& str, size_type pos = npos) const {
-            return find_last_not_of(str.c_str(), pos, str.size());
+        size_type find_last_of(const CharT* s, size_type pos, size_type count) const noexcept {
+            return detail::reverse_find_in_set<Traits, true>(data(), size(), pos, s, count);
         }
 
-        size_type find_last_not_of(const CharT* s, size_type pos, size_type count) const {
-            if (size() == 0)
-                return npos;
+        size_type find_last_of(const CharT* s, size_type pos = npos) const noexcept {
+            return find_last_of(s, pos, Traits::length(s));
+        }
 
-            size_type start = (pos >= size()) ? size() - 1 : pos;
-            for (size_type i = start; i != npos; --i) {
-                bool found = false;
-                for (size_type j = 0; j < count; ++j) {
-                    if (_elems[i] == s[j]) {
-                        found = true;
-                        break;
-                    }
-                }
-                if (!found) return i;
-                if (i == 0) break;
-            }
-            return npos;
+        size_type find_last_of(CharT ch, size_type pos = npos) const noexcept {
+            return detail::rfind_char<Traits>(data(), size(), pos, ch);
         }
 
-        size_type find_last_not_of(const CharT* s, size_type pos = npos) const {
-            if (size() == 0)
-                return npos;
+        size_type find_last_not_of(const basic_string& str, size_type pos = npos) const noexcept {
+            return find_last_not_of(str.data(), pos, str.size());
+        }
 
-            size_type len_s = std::char_traits<CharT>::length(s);
-            if (len_s == 0)
-                return npos;
+        template<typename T, _if_view<T> = 0>
+        size_type find_last_not_of(const T& t, size_type pos = npos) const noexcept(std::is_nothrow_constructible_v<_view, const T&>) {
+            const _view sv = t;
+            return find_last_not_of(sv.data(), pos, sv.size());
+        }
 
-            size_type start = (pos >= size()) ? size() - 1 : pos;
-            for (size_type i = start; i != npos; --i) {
-                bool found = false;
-                for (size_type j = 0; j < len_s; ++j) {
-                    if (_elems[i] == s[j]) {
-                        found = true;
-                        break;
-                    }
-                }
-                if (!found) return i;
-                if (i == 0) break;
-            }
-            return npos;
+        size_type find_last_not_of(const CharT* s, size_type pos, size_type count) const noexcept {
+            return detail::reverse_find_in_set<Traits, false>(data(), size(), pos, s, count);
         }
 
-        size_type find_last_not_of(CharT ch, size_type pos = npos) const {
-            if (size() == 0)
-                return npos;
+        size_type find_last_not_of(const CharT* s, size_type pos = npos) const noexcept {
+            return find_last_not_of(s, pos, Traits::length(s));
+        }
 
-            size_type start = (pos >= size()) ? size() - 1 : pos;
-            for (size_type i = start; i != npos; --i) {
-                if (_elems[i] != ch)
-                    return i;
-                if (i == 0) break;
-            }
-            return npos;
+        size_type find_last_not_of(CharT ch, size_type pos = npos) const noexcept {
+            return find_last_not_of(&ch, pos, 1);
         }
 
         int compare(const basic_string& str) const noexcept {
             size_type min_len = std::min(size(), str.size());
-            int result = std::char_traits<CharT>::compare(data(), str.data(), min_len);
+            int result = Traits::compare(data(), str.data(), min_len);
             if (result != 0) return result;
             if (size() < str.size()) return -1;
             if (size() > str.size()) return 1;
@@ -1155,10 +954,29 @@ namespace lzt {
             return compare(pos1, count1, str.data() + pos2, real_count2);
         }
 
+        template<typename T, _if_view<T> = 0>
+        int compare(const T& t) const noexcept(std::is_nothrow_constructible_v<_view, const T&>) {
+            const _view sv = t;
+            return _view(*this).compare(sv);
+        }
+
+        template<typename T, _if_view<T> = 0>
+        int compare(size_type pos1, size_type count1, const T& t) const {
+            const _view sv = t;
+            return compare(pos1, count1, sv.data(), sv.size());
+        }
+
+        template<typename T, _if_view<T> = 0>
+        int compare(size_type pos1, size_type count1, const T& t,
+                    size_type pos2, size_type count2 = npos) const {
+            const _view sv = _view(t).substr(pos2, count2);
+            return compare(pos1, count1, sv.data(), sv.size());
+        }
+
         int compare(const CharT* s) const {
-            size_type len_s = std::char_traits<CharT>::length(s);
+            size_type len_s = Traits::length(s);
             size_type min_len = std::min(size(), len_s);
-            int result = std::char_traits<CharT>::compare(data(), s, min_len);
+            int result = Traits::compare(data(), s, min_len);
             if (result != 0) return result;
             if (size() < len_s) return -1;
             if (size() > len_s) return 1;
@@ -1171,10 +989,10 @@ namespace lzt {
                 throw std::out_of_range("compare: pos1 out of range");
 
             size_type real_count1 = std::min(count1, size() - pos1);
-            size_type len_s = std::char_traits<CharT>::length(s);
+            size_type len_s = Traits::length(s);
             size_type min_len = std::min(real_count1, len_s);
 
-            int result = std::char_traits<CharT>::compare(data() + pos1, s, min_len);
+            int result = Traits::compare(data() + pos1, s, min_len);
             if (result != 0) return result;
             if (real_count1 < len_s) return -1;
             if (real_count1 > len_s) return 1;
@@ -1189,7 +1007,7 @@ namespace lzt {
             size_type real_count1 = std::min(count1, size() - pos1);
             size_type min_len = std::min(real_count1, count2);
 
-            int result = std::char_traits<CharT>::compare(data() + pos1, s, min_len);
+            int result = Traits::compare(data() + pos1, s, min_len);
             if (result != 0) return result;
             if (real_count1 < count2) return -1;
             if (real_count1 > count2) return 1;
@@ -1203,66 +1021,499 @@ namespace lzt {
             size_type real_count = std::min(count, size() - pos);
             return basic_string(data() + pos, real_count);
         }
+
+        template<typename C, typename T, typename A>
+        friend std::basic_istream<C, T>& operator>>(std::basic_istream<C, T>& is,
+                                                    basic_string<C, T, A>& str);
+
+        template<typename C, typename T, typename A>
+        friend std::basic_istream<C, T>& getline(std::basic_istream<C, T>& is,
+                                                 basic_string<C, T, A>& str, C delim);
     private:
+        static constexpr size_type _local_capacity = 16 / sizeof(CharT) < 1 ? 1 : 16 / sizeof(CharT);
+
+        constexpr Allocator& _alloc() noexcept {
+            return myAlloc::get();
+        }
+
+        constexpr const Allocator& _alloc() const noexcept {
+            return myAlloc::get();
+        }
+
+        constexpr bool _is_local() const noexcept {
+            return _capacity == _local_capacity;
+        }
+
+        constexpr pointer _elems() noexcept {
+            return _is_local() ? _bx._buffer : _bx._pointer;
+        }
+
+        constexpr const_pointer _elems() const noexcept {
+            return _is_local() ? _bx._buffer : _bx._pointer;
+        }
+
+        void _become_local() noexcept {
+            _size = 0;
+            _capacity = _local_capacity;
+            _bx._buffer[0] = CharT();
+        }
+
+        void _steal(basic_string& other) noexcept {
+            _bx = other._bx;
+            _size = other._size;
+            _capacity = other._capacity;
+            other._become_local();
+        }
+
+        void _assign(const CharT* s, size_type count) {
+            if (count + 1 > _capacity) {
+                _deallocate();
+                _allocate(count + 1);
+            }
+
+            Traits::move(_elems(), s, count);
+            _size = count;
+            _elems()[_size] = CharT();
+        }
+
+        bool _is_inside(const CharT* s) const noexcept {
+            return std::less_equal<const CharT*>()(data(), s)
+                && std::less<const CharT*>()(s, data() + _size);
+        }
+
+        void _grow_to(size_type newSize) {
+            if (newSize > max_size())
+                throw std::length_error("basic_string: maximum size exceeded");
+
+            if (newSize + 1 > _capacity)
+                _reallocate(string_growth_policy<CharT>::next_capacity(_capacity, newSize + 1));
+        }
+
+        // Replaces [pos, pos + count1) with an uninitialized gap of count2
+        // characters, moving the tail at most once, and returns the gap.
+        CharT* _replace_gap(size_type pos, size_type count1, size_type count2) {
+            if (count2 > max_size() - (size() - count1))
+                throw std::length_error("basic_string: maximum size exceeded");
+
+            const size_type tail = size() - pos - count1;
+            const size_type newSize = size() - count1 + count2;
+
+            if (newSize + 1 > _capacity) {
+                const size_type newCapacity = string_growth_policy<CharT>::next_capacity(_capacity, newSize + 1);
+                CharT* newData = alloc_traits::allocate(_alloc(), newCapacity);
+                Traits::copy(newData, _elems(), pos);
+                Traits::copy(newData + pos + count2, _elems() + pos + count1, tail);
+
+                if (!_is_local())
+                    alloc_traits::deallocate(_alloc(), _bx._pointer, _capacity);
+
+                _bx._pointer = newData;
+                _capacity = newCapacity;
+            } else if (count1 != count2) {
+                Traits::move(_elems() + pos + count2, _elems() + pos + count1, tail);
+            }
+
+            _size = newSize;
+            _elems()[_size] = CharT();
+            return _elems() + pos;
+        }
+
+        // Returns the earliest match at or after pos over all patterns, the
+        // first listed pattern winning ties. next caches each pattern's
+        // previous hit so every pattern is searched once per match it makes.
+        size_type _next_match(const std::pair<_view, _view>* patterns, size_t count,
+                              size_type* next, size_type pos, size_t& which) const noexcept {
+            size_type best = npos;
+            for (size_t i = 0; i < count; ++i) {
+                if (next[i] != npos && next[i] < pos)
+                    next[i] = find(patterns[i].first, pos);
+
+                if (next[i] < best) {
+                    best = next[i];
+                    which = i;
+                }
+            }
+            return best;
+        }
+
+        void _reset_matches(const std::pair<_view, _view>* patterns, size_t count,
+                            size_type* next) const noexcept {
+            for (size_t i = 0; i < count; ++i)
+                next[i] = patterns[i].first.empty() ? npos : find(patterns[i].first);
+        }
+
+        basic_string& _replace_all(const std::pair<_view, _view>* patterns, size_t count) {
+            size_type localNext[8];
+            std::unique_ptr<size_type[]> heapNext;
+            size_type* next = localNext;
+            if (count > 8) {
+                heapNext.reset(new size_type[count]);
+                next = heapNext.get();
+            }
+
+            size_type newSize = size();
+            size_t which = 0;
+            bool found = false;
+            bool grows = false;
+            bool aliased = false;
+            _reset_matches(patterns, count, next);
+            for (size_type pos = _next_match(patterns, count, next, 0, which); pos != npos;
+                 pos = _next_match(patterns, count, next, pos + patterns[which].first.size(), which)) {
+                const _view& to = patterns[which].second;
+                if (to.size() > max_size() - newSize)
+                    throw std::length_error("basic_string: maximum size exceeded");
+
+                newSize = newSize - patterns[which].first.size() + to.size();
+                grows = grows || to.size() > patterns[which].first.size();
+                aliased = aliased || _is_inside(to.data());
+                found = true;
+            }
+
+            if (!found)
+                return *this;
+
+            for (size_t i = 0; i < count; ++i)
+                aliased = aliased || _is_inside(patterns[i].first.data());
+
+            // Without a growing substitution the writes never overtake the
+            // scan, so the result is compacted in place.
+            const bool inPlace = !grows && !aliased;
+            basic_string result(_alloc());
+            if (!inPlace)
+                result._allocate(newSize + 1);
+
+            const CharT* src = data();
+            CharT* dest = inPlace ? _elems() : result._elems();
+            size_type last = 0;
+            _reset_matches(patterns, count, next);
+            for (size_type pos = _next_match(patterns, count, next, 0, which); pos != npos;
+                 pos = _next_match(patterns, count, next, last, which)) {
+                const _view& to = patterns[which].second;
+                Traits::move(dest, src + last, pos - last);
+                dest += pos - last;
+                Traits::copy(dest, to.data(), to.size());
+                dest += to.size();
+                last = pos + patterns[which].first.size();
+            }
+            Traits::move(dest, src + last, size() - last);
+
+            if (inPlace) {
+                _size = newSize;
+                _elems()[_size] = CharT();
+            } else {
+                result._size = newSize;
+                result._elems()[newSize] = CharT();
+                _deallocate();
+                _steal(result);
+            }
+            return *this;
+        }
+
         void _allocate(size_t capacity) {
-            _elems = (CharT*)::operator new(capacity * sizeof(CharT));
+            _size = 0;
+            if (capacity <= _local_capacity) {
+                _capacity = _local_capacity;
+                return;
+            }
+
+            _bx._pointer = alloc_traits::allocate(_alloc(), capacity);
             _capacity = capacity;
         }
 
         void _reallocate(size_t newCapacity) {
-            if (newCapacity == 0)
-                newCapacity = 1;
-
             if (newCapacity < size() + 1)
                 newCapacity = size() + 1;
 
-            CharT* newData = (CharT*)::operator new(newCapacity * sizeof(CharT));
+            if (newCapacity <= _local_capacity) {
+                if (_is_local())
+                    return;
+
+                CharT* oldData = _bx._pointer;
+                Traits::copy(_bx._buffer, oldData, size());
 
-            for (size_t i = 0; i < size(); ++i) {
-                new (&newData[i]) CharT(std::move(_elems[i]));
-                _elems[i].~CharT();
+                alloc_traits::deallocate(_alloc(), oldData, _capacity);
+                _capacity = _local_capacity;
+                _bx._buffer[_size] = CharT();
+                return;
             }
 
-            ::operator delete(_elems);
-            _elems = newData;
+            CharT* newData = alloc_traits::allocate(_alloc(), newCapacity);
+            CharT* oldData = _elems();
+
+            Traits::copy(newData, oldData, size());
+
+            if (!_is_local())
+                alloc_traits::deallocate(_alloc(), oldData, _capacity);
+
+            _bx._pointer = newData;
             _capacity = newCapacity;
-            _elems[_size] = CharT();
+            _bx._pointer[_size] = CharT();
         }
 
         void _deallocate() {
-            for (size_t i = 0; i < size(); ++i)
-                _elems[i].~CharT();
-
-            ::operator delete(_elems);
-            _elems = nullptr;
-            _size = 0;
-            _capacity = 0;
+            if (!_is_local())
+                alloc_traits::deallocate(_alloc(), _bx._pointer, _capacity);
+            _become_local();
         }
     private:
-        CharT* _elems = nullptr;
+        union _storage {
+            CharT _buffer[_local_capacity];
+            CharT* _pointer;
+        };
+
+        _storage _bx;
         size_t _size = 0;
-        size_t _capacity = 0;
+        size_t _capacity = _local_capacity;
     };
 
-    template<typename CharT>
-    std::basic_ostream<CharT>& operator<<(std::basic_ostream<CharT>& os, const basic_string<CharT>& str) {
+    template<typename CharT, typename Traits, typename Allocator>
+    struct is_trivially_relocatable<basic_string<CharT, Traits, Allocator>>
+        : std::bool_constant<is_trivially_relocatable_v<Allocator>> {};
+
+    // Comparisons with a view go through the basic_string_view operators.
+    template<typename CharT, typename Traits, typename Allocator>
+    bool operator==(const basic_string<CharT, Traits, Allocator>& lhs, const basic_string<CharT, Traits, Allocator>& rhs) noexcept {
+        return lhs.size() == rhs.size() && Traits::compare(lhs.data(), rhs.data(), lhs.size()) == 0;
+    }
+
+    template<typename CharT, typename Traits, typename Allocator>
+    bool operator==(const basic_string<CharT, Traits, Allocator>& lhs, const CharT* rhs) {
+        return lhs.compare(rhs) == 0;
+    }
+
+    template<typename CharT, typename Traits, typename Allocator>
+    bool operator==(const CharT* lhs, const basic_string<CharT, Traits, Allocator>& rhs) {
+        return rhs.compare(lhs) == 0;
+    }
+
+    template<typename CharT, typename Traits, typename Allocator>
+    bool operator!=(const basic_string<CharT, Traits, Allocator>& lhs, const basic_string<CharT, Traits, Allocator>& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+    template<typename CharT, typename Traits, typename Allocator>
+    bool operator!=(const basic_string<CharT, Traits, Allocator>& lhs, const CharT* rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<typename CharT, typename Traits, typename Allocator>
+    bool operator!=(const CharT* lhs, const basic_string<CharT, Traits, Allocator>& rhs) {
+        return !(lhs == rhs);
+    }
+
+    template<typename CharT, typename Traits, typename Allocator>
+    bool operator<(const basic_string<CharT, Traits, Allocator>& lhs, const basic_string<CharT, Traits, Allocator>& rhs) noexcept {
+        return lhs.compare(rhs) < 0;
+    }
+
+    template<typename CharT, typename Traits, typename Allocator>
+    bool operator<(const basic_string<CharT, Traits, Allocator>& lhs, const CharT* rhs) {
+        return lhs.compare(rhs) < 0;
+    }
+
+    template<typename CharT, typename Traits, typename Allocator>
+    bool operator<(const CharT* lhs, const basic_string<CharT, Traits, Allocator>& rhs) {
+        return rhs.compare(lhs) > 0;
+    }
+
+    template<typename CharT, typename Traits, typename Allocator>
+    bool operator>(const basic_string<CharT, Traits, Allocator>& lhs, const basic_string<CharT, Traits, Allocator>& rhs) noexcept {
+        return lhs.compare(rhs) > 0;
+    }
+
+    template<typename CharT, typename Traits, typename Allocator>
+    bool operator>(const basic_string<CharT, Traits, Allocator>& lhs, const CharT* rhs) {
+        return lhs.compare(rhs) > 0;
+    }
+
+    template<typename CharT, typename Traits, typename Allocator>
+    bool operator>(const CharT* lhs, const basic_string<CharT, Traits, Allocator>& rhs) {
+        return rhs.compare(lhs) < 0;
+    }
+
+    template<typename CharT, typename Traits, typename Allocator>
+    bool operator<=(const basic_string<CharT, Traits, Allocator>& lhs, const basic_string<CharT, Traits, Allocator>& rhs) noexcept {
+        return lhs.compare(rhs) <= 0;
+    }
+
+    template<typename CharT, typename Traits, typename Allocator>
+    bool operator<=(const basic_string<CharT, Traits, Allocator>& lhs, const CharT* rhs) {
+        return lhs.compare(rhs) <= 0;
+    }
+
+    template<typename CharT, typename Traits, typename Allocator>
+    bool operator<=(const CharT* lhs, const basic_string<CharT, Traits, Allocator>& rhs) {
+        return rhs.compare(lhs) >= 0;
+    }
+
+    template<typename CharT, typename Traits, typename Allocator>
+    bool operator>=(const basic_string<CharT, Traits, Allocator>& lhs, const basic_string<CharT, Traits, Allocator>& rhs) noexcept {
+        return lhs.compare(rhs) >= 0;
+    }
+
+    template<typename CharT, typename Traits, typename Allocator>
+    bool operator>=(const basic_string<CharT, Traits, Allocator>& lhs, const CharT* rhs) {
+        return lhs.compare(rhs) >= 0;
+    }
+
+    template<typename CharT, typename Traits, typename Allocator>
+    bool operator>=(const CharT* lhs, const basic_string<CharT, Traits, Allocator>& rhs) {
+        return rhs.compare(lhs) <= 0;
+    }
+
+    template<typename CharT, typename Traits, typename Allocator>
+    std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os,
+                                                  const basic_string<CharT, Traits, Allocator>& str) {
         return os << str.c_str();
     }
 
-    template<typename CharT>
-    std::basic_istream<CharT>& operator>>(std::basic_istream<CharT>& is, basic_string<CharT>& str) {
-        str.clear();
-        CharT ch;
-        while (is.get(ch) && !std::isspace(ch, is.getloc())) {
-            str.push_back(ch);
+    template<typename CharT, typename Traits, typename Allocator>
+    std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is,
+                                                  basic_string<CharT, Traits, Allocator>& str) {
+        using size_type = typename basic_string<CharT, Traits, Allocator>::size_type;
+
+        std::ios_base::iostate state = std::ios_base::goodbit;
+        size_type extracted = 0;
+        const typename std::basic_istream<CharT, Traits>::sentry guard(is);
+        if (guard) {
+            str.erase();
+            const std::ctype<CharT>& ct = std::use_facet<std::ctype<CharT>>(is.getloc());
+            const size_type limit = is.width() > 0 ? static_cast<size_type>(is.width()) : str.max_size();
+            std::basic_streambuf<CharT, Traits>* sb = is.rdbuf();
+
+            while (extracted < limit) {
+                const std::streamsize avail = detail::buffered_chars(sb);
+                if (avail < 0) {
+                    state |= std::ios_base::eofbit;
+                    break;
+                }
+
+                if (avail == 0) {
+                    const CharT ch = Traits::to_char_type(sb->sgetc());
+                    if (ct.is(std::ctype_base::space, ch))
+                        break;
+
+                    str.push_back(ch);
+                    sb->sbumpc();
+                    ++extracted;
+                    continue;
+                }
+
+                const CharT* first = detail::streambuf_access<CharT, Traits>::get_pointer(sb);
+                const CharT* last = first + std::min(static_cast<size_type>(avail), limit - extracted);
+                const CharT* space = ct.scan_is(std::ctype_base::space, first, last);
+
+                const size_type count = static_cast<size_type>(space - first);
+                if (count != 0) {
+                    const size_type got = static_cast<size_type>(
+                        sb->sgetn(str._replace_gap(str.size(), 0, count), static_cast<std::streamsize>(count)));
+                    str.resize(str.size() - count + got);
+                    extracted += got;
+                }
+
+                if (space != last)
+                    break;
+            }
+            is.width(0);
+        }
+
+        if (extracted == 0)
+            state |= std::ios_base::failbit;
+        is.setstate(state);
+        return is;
+    }
+
+    template<typename CharT, typename Traits, typename Allocator>
+    std::basic_istream<CharT, Traits>& getline(std::basic_istream<CharT, Traits>& is,
+                                               basic_string<CharT, Traits, Allocator>& str, CharT delim) {
+        using size_type = typename basic_string<CharT, Traits, Allocator>::size_type;
+
+        std::ios_base::iostate state = std::ios_base::goodbit;
+        size_type extracted = 0;
+        const typename std::basic_istream<CharT, Traits>::sentry guard(is, true);
+        if (guard) {
+            str.erase();
+            std::basic_streambuf<CharT, Traits>* sb = is.rdbuf();
+
+            while (true) {
+                const std::streamsize avail = detail::buffered_chars(sb);
+                if (avail < 0) {
+                    state |= std::ios_base::eofbit;
+                    break;
+                }
+
+                if (avail == 0) {
+                    const CharT ch = Traits::to_char_type(sb->sbumpc());
+                    ++extracted;
+                    if (Traits::eq(ch, delim))
+                        break;
+
+                    if (str.size() == str.max_size()) {
+                        state |= std::ios_base::failbit;
+                        break;
+                    }
+                    str.push_back(ch);
+                    continue;
+                }
+
+                const CharT* first = detail::streambuf_access<CharT, Traits>::get_pointer(sb);
+                const size_type found = detail::find_char<Traits>(first, static_cast<size_type>(avail), 0, delim);
+                const size_type count = found == detail::search_npos ? static_cast<size_type>(avail) : found;
+
+                if (count > str.max_size() - str.size()) {
+                    state |= std::ios_base::failbit;
+                    break;
+                }
+
+                if (count != 0) {
+                    const size_type got = static_cast<size_type>(
+                        sb->sgetn(str._replace_gap(str.size(), 0, count), static_cast<std::streamsize>(count)));
+                    str.resize(str.size() - count + got);
+                    extracted += got;
+                }
+
+                if (found != detail::search_npos) {
+                    sb->sbumpc();
+                    ++extracted;
+                    break;
+                }
+            }
         }
+
+        if (extracted == 0)
+            state |= std::ios_base::failbit;
+        is.setstate(state);
         return is;
     }
 
+    template<typename CharT, typename Traits, typename Allocator>
+    std::basic_istream<CharT, Traits>& getline(std::basic_istream<CharT, Traits>& is,
+                                               basic_string<CharT, Traits, Allocator>& str) {
+        return getline(is, str, is.widen('\n'));
+    }
+
     using string = basic_string<char>;
     using wstring = basic_string<wchar_t>;
     using u16string = basic_string<char16_t>;
     using u32string = basic_string<char32_t>;
+
+    using ci_string = basic_string<char, ci_char_traits<char>>;
+    using ci_wstring = basic_string<wchar_t, ci_char_traits<wchar_t>>;
+
+    template<typename CharT, typename Allocator>
+    struct hash<basic_string<CharT, std::char_traits<CharT>, Allocator>> : hash<basic_string_view<CharT>> {};
+
+    template<typename CharT, typename Allocator>
+    struct equal_to<basic_string<CharT, std::char_traits<CharT>, Allocator>> : equal_to<basic_string_view<CharT>> {};
+}
+
+namespace std {
+    template<typename CharT, typename Allocator>
+    struct hash<lzt::basic_string<CharT, std::char_traits<CharT>, Allocator>> {
+        size_t operator()(const lzt::basic_string<CharT, std::char_traits<CharT>, Allocator>& str) const noexcept {
+            return lzt::hash<lzt::basic_string_view<CharT>>()(str);
+        }
+    };
 }
 
 #endif // LZT_STRING_H
\ No newline at end of file
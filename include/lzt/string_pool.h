@@ -0,0 +1,292 @@
+#ifndef LZT_STRING_POOL_H
+#define LZT_STRING_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <memory>
+#include <string>
+#include <optional>
+#include <stdexcept>
+#include <mutex>
+#include <shared_mutex>
+#include "hash.h"
+#include "vector.h"
+#include "string_view.h"
+#include "flat_hash_map.h"
+#include "detail/simd.h"
+
+namespace lzt {
+    // Handle to a string interned in a string_pool. Two atoms from the same
+    // pool are equal exactly when their strings are; atoms from different
+    // pools must not be mixed. The default atom is the empty string.
+    class atom {
+    public:
+        constexpr atom() noexcept = default;
+
+        constexpr explicit atom(uint32_t id) noexcept : _id(id) {}
+
+        constexpr uint32_t id() const noexcept {
+            return _id;
+        }
+
+        friend constexpr bool operator==(atom lhs, atom rhs) noexcept {
+            return lhs._id == rhs._id;
+        }
+
+        friend constexpr bool operator!=(atom lhs, atom rhs) noexcept {
+            return lhs._id != rhs._id;
+        }
+
+        // Orders by interning time, not lexicographically.
+        friend constexpr bool operator<(atom lhs, atom rhs) noexcept {
+            return lhs._id < rhs._id;
+        }
+    private:
+        uint32_t _id = 0;
+    };
+
+    template<>
+    struct is_contiguously_hashable<atom> : std::true_type {};
+
+    // Stores each distinct string once. Characters live in large chunks
+    // that never move, so views returned by the pool stay valid until it is
+    // cleared or destroyed, and every string is null-terminated. The atom
+    // table is split into segments of doubling size for the same reason:
+    // view(atom) may run concurrently with intern().
+    template<typename CharT, typename Allocator = std::allocator<CharT>>
+    class basic_string_pool {
+    private:
+        using _view = basic_string_view<CharT>;
+        using _alloc_traits = std::allocator_traits<Allocator>;
+        using _view_alloc = typename _alloc_traits::template rebind_alloc<_view>;
+        using _view_alloc_traits = std::allocator_traits<_view_alloc>;
+        using _index_alloc = typename _alloc_traits::template rebind_alloc<std::pair<const _view, uint32_t>>;
+        using _chunk_alloc = typename _alloc_traits::template rebind_alloc<std::pair<CharT*, size_t>>;
+    public:
+        using value_type = CharT;
+        using size_type = size_t;
+        using allocator_type = Allocator;
+
+        static constexpr size_type default_chunk_size = 64 * 1024 / sizeof(CharT);
+    public:
+        explicit basic_string_pool(size_type chunk_size = default_chunk_size, const Allocator& alloc = Allocator())
+            : _chunkSize(chunk_size < 64 ? 64 : chunk_size), _alloc(alloc),
+              _index(0, hash<_view>(), equal_to<_view>(), _index_alloc(alloc)), _chunks(_chunk_alloc(alloc)) {
+            intern(_view());
+        }
+
+        basic_string_pool(const basic_string_pool&) = delete;
+
+        basic_string_pool& operator=(const basic_string_pool&) = delete;
+
+        ~basic_string_pool() {
+            _tidy();
+        }
+
+        atom intern(_view str) {
+            typename decltype(_index)::iterator it = _index.find(str);
+            if (it != _index.end())
+                return atom(it->second);
+
+            if (_size == _max_atoms)
+                throw std::length_error("string_pool: too many strings");
+
+            _view* slot = _slot(_size);
+            const _view stored = _store(str);
+            ::new (static_cast<void*>(slot)) _view(stored);
+            _index.try_emplace(stored, _size);
+            return atom(_size++);
+        }
+
+        std::optional<atom> find(_view str) const {
+            typename decltype(_index)::const_iterator it = _index.find(str);
+            if (it == _index.end())
+                return std::nullopt;
+            return atom(it->second);
+        }
+
+        _view view(atom a) const noexcept {
+            const uint32_t bucket = (a.id() >> _first_segment_bits) + 1;
+            const unsigned segment = detail::highest_bit(bucket);
+            return _segments[segment][a.id() - ((uint32_t(1) << segment) - 1) * _first_segment_size];
+        }
+
+        _view operator[](atom a) const noexcept {
+            return view(a);
+        }
+
+        const CharT* c_str(atom a) const noexcept {
+            return view(a).data();
+        }
+
+        // Number of distinct strings, including the empty one.
+        size_type size() const noexcept {
+            return _size;
+        }
+
+        size_type memory_usage() const noexcept {
+            size_type bytes = 0;
+            for (const std::pair<CharT*, size_t>& chunk : _chunks)
+                bytes += chunk.second * sizeof(CharT);
+            for (unsigned i = 0; i < _segment_count && _segments[i]; ++i)
+                bytes += _segment_size(i) * sizeof(_view);
+            return bytes + _index.capacity() * (sizeof(std::pair<const _view, uint32_t>) + 1);
+        }
+
+        void clear() {
+            _tidy();
+            _index.clear();
+            intern(_view());
+        }
+    private:
+        static constexpr unsigned _first_segment_bits = 10;
+        static constexpr uint32_t _first_segment_size = uint32_t(1) << _first_segment_bits;
+        static constexpr unsigned _segment_count = 32 - _first_segment_bits + 1;
+        static constexpr uint32_t _max_atoms = UINT32_MAX;
+
+        static size_type _segment_size(unsigned segment) noexcept {
+            return size_type(_first_segment_size) << segment;
+        }
+
+        _view* _slot(uint32_t id) {
+            const uint32_t bucket = (id >> _first_segment_bits) + 1;
+            const unsigned segment = detail::highest_bit(bucket);
+            if (!_segments[segment]) {
+                _view_alloc alloc(_alloc);
+                _segments[segment] = _view_alloc_traits::allocate(alloc, _segment_size(segment));
+            }
+            return _segments[segment] + (id - ((uint32_t(1) << segment) - 1) * _first_segment_size);
+        }
+
+        // Small strings are bumped out of the current chunk; anything larger
+        // than a quarter chunk gets its own block so chunks are not wasted.
+        _view _store(_view str) {
+            const size_type needed = str.size() + 1;
+            CharT* dest;
+            if (needed > _chunkSize / 4) {
+                dest = _allocate_chunk(needed);
+            } else {
+                if (_remaining < needed) {
+                    _cursor = _allocate_chunk(_chunkSize);
+                    _remaining = _chunkSize;
+                }
+                dest = _cursor;
+                _cursor += needed;
+                _remaining -= needed;
+            }
+
+            std::char_traits<CharT>::copy(dest, str.data(), str.size());
+            std::char_traits<CharT>::assign(dest[str.size()], CharT());
+            return _view(dest, str.size());
+        }
+
+        CharT* _allocate_chunk(size_type count) {
+            CharT* chunk = _alloc_traits::allocate(_alloc, count);
+            try {
+                _chunks.push_back({ chunk, count });
+            } catch (...) {
+                _alloc_traits::deallocate(_alloc, chunk, count);
+                throw;
+            }
+            return chunk;
+        }
+
+        void _tidy() noexcept {
+            for (const std::pair<CharT*, size_t>& chunk : _chunks)
+                _alloc_traits::deallocate(_alloc, chunk.first, chunk.second);
+            _chunks.clear();
+
+            _view_alloc alloc(_alloc);
+            for (unsigned i = 0; i < _segment_count; ++i) {
+                if (_segments[i])
+                    _view_alloc_traits::deallocate(alloc, _segments[i], _segment_size(i));
+                _segments[i] = nullptr;
+            }
+
+            _cursor = nullptr;
+            _remaining = 0;
+            _size = 0;
+        }
+    private:
+        size_type _chunkSize;
+        Allocator _alloc;
+        flat_hash_map<_view, uint32_t, hash<_view>, equal_to<_view>, _index_alloc> _index;
+        vector<std::pair<CharT*, size_t>, _chunk_alloc> _chunks;
+        _view* _segments[_segment_count] = {};
+        CharT* _cursor = nullptr;
+        size_type _remaining = 0;
+        uint32_t _size = 0;
+    };
+
+    // Thread-safe pool: lookups of known strings share a reader lock, only
+    // new strings take the writer lock. view() takes no lock at all.
+    template<typename CharT, typename Allocator = std::allocator<CharT>>
+    class basic_concurrent_string_pool {
+    private:
+        using _view = basic_string_view<CharT>;
+        using _pool = basic_string_pool<CharT, Allocator>;
+    public:
+        using value_type = CharT;
+        using size_type = size_t;
+        using allocator_type = Allocator;
+    public:
+        explicit basic_concurrent_string_pool(size_type chunk_size = _pool::default_chunk_size,
+                                              const Allocator& alloc = Allocator())
+            : _strings(chunk_size, alloc) {}
+
+        atom intern(_view str) {
+            {
+                std::shared_lock<std::shared_mutex> lock(_mutex);
+                if (std::optional<atom> found = _strings.find(str))
+                    return *found;
+            }
+
+            std::unique_lock<std::shared_mutex> lock(_mutex);
+            return _strings.intern(str);
+        }
+
+        std::optional<atom> find(_view str) const {
+            std::shared_lock<std::shared_mutex> lock(_mutex);
+            return _strings.find(str);
+        }
+
+        // The atom must have been obtained from this pool, which orders the
+        // read after the write that stored it.
+        _view view(atom a) const noexcept {
+            return _strings.view(a);
+        }
+
+        _view operator[](atom a) const noexcept {
+            return view(a);
+        }
+
+        const CharT* c_str(atom a) const noexcept {
+            return view(a).data();
+        }
+
+        size_type size() const {
+            std::shared_lock<std::shared_mutex> lock(_mutex);
+            return _strings.size();
+        }
+    private:
+        mutable std::shared_mutex _mutex;
+        _pool _strings;
+    };
+
+    using string_pool = basic_string_pool<char>;
+    using wstring_pool = basic_string_pool<wchar_t>;
+    using concurrent_string_pool = basic_concurrent_string_pool<char>;
+    using concurrent_wstring_pool = basic_concurrent_string_pool<wchar_t>;
+}
+
+namespace std {
+    template<>
+    struct hash<lzt::atom> {
+        size_t operator()(lzt::atom a) const noexcept {
+            return lzt::hash<lzt::atom>()(a);
+        }
+    };
+}
+
+#endif // LZT_STRING_POOL_H
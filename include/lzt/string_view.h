@@ -0,0 +1,602 @@
+#ifndef LZT_STRING_VIEW_H
+#define LZT_STRING_VIEW_H
+
+#include <ostream>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include "hash.h"
+#include "type_traits.h"
+#include "detail/string_search.h"
+
+namespace lzt {
+    template<typename basic_string>
+    class string_const_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = typename basic_string::value_type;
+        using difference_type = typename basic_string::difference_type;
+        using pointer = typename basic_string::const_pointer;
+        using reference = typename basic_string::const_reference;
+    public:
+        constexpr string_const_iterator() noexcept = default;
+
+        constexpr explicit string_const_iterator(pointer ptr) : _pointer(ptr) {}
+
+        constexpr reference operator*() const noexcept {
+            return *_pointer;
+        }
+
+        constexpr pointer operator->() const noexcept {
+            return _pointer;
+        }
+
+        constexpr string_const_iterator& operator++() noexcept {
+            ++_pointer;
+            return *this;
+        }
+
+        constexpr string_const_iterator operator++(int) noexcept {
+            string_const_iterator temp = *this;
+            ++(*this);
+            return temp;
+        }
+
+        constexpr string_const_iterator& operator--() noexcept {
+            --_pointer;
+            return *this;
+        }
+
+        constexpr string_const_iterator operator--(int) noexcept {
+            string_const_iterator temp = *this;
+            --(*this);
+            return temp;
+        }
+
+        constexpr string_const_iterator& operator+=(const difference_type offset) noexcept {
+            _pointer += offset;
+            return *this;
+        }
+
+        constexpr string_const_iterator operator+(const difference_type offset) const noexcept {
+            return string_const_iterator(_pointer + offset);
+        }
+
+        friend constexpr string_const_iterator operator+(
+            const difference_type offset, string_const_iterator next) noexcept {
+            next += offset;
+            return next;
+        }
+
+        constexpr string_const_iterator& operator-=(const difference_type offset) noexcept {
+            _pointer -= offset;
+            return *this;
+        }
+
+        constexpr string_const_iterator operator-(const difference_type offset) const noexcept {
+            return string_const_iterator(_pointer - offset);
+        }
+
+        constexpr difference_type operator-(const string_const_iterator& other) const noexcept {
+            return static_cast<difference_type>(_pointer - other._pointer);
+        }
+
+        constexpr reference operator[](const difference_type offset) const noexcept {
+            return *(*this + offset);
+        }
+
+        constexpr bool operator==(const string_const_iterator& other) const noexcept {
+            return _pointer == other._pointer;
+        }
+
+        constexpr bool operator!=(const string_const_iterator& other) const noexcept {
+            return !(*this == other);
+        }
+
+        constexpr bool operator<(const string_const_iterator& other) const noexcept {
+            return _pointer < other._pointer;
+        }
+
+        constexpr bool operator>(const string_const_iterator& other) const noexcept {
+            return other < *this;
+        }
+
+        constexpr bool operator<=(const string_const_iterator& other) const noexcept {
+            return !(other < *this);
+        }
+
+        constexpr bool operator>=(const string_const_iterator& other) const noexcept {
+            return !(*this < other);
+        }
+    protected:
+        pointer _pointer;
+    };
+
+    template<typename CharT>
+    struct ci_char_traits : std::char_traits<CharT> {
+        using char_type = CharT;
+        using int_type = typename std::char_traits<CharT>::int_type;
+
+        static constexpr CharT fold(CharT ch) noexcept {
+            return (ch >= CharT('A') && ch <= CharT('Z')) ? CharT(ch - CharT('A') + CharT('a')) : ch;
+        }
+
+        static constexpr bool eq(CharT lhs, CharT rhs) noexcept {
+            return fold(lhs) == fold(rhs);
+        }
+
+        static constexpr bool lt(CharT lhs, CharT rhs) noexcept {
+            return fold(lhs) < fold(rhs);
+        }
+
+        static constexpr int compare(const CharT* lhs, const CharT* rhs, size_t count) noexcept {
+            for (size_t i = 0; i < count; ++i) {
+                if (lt(lhs[i], rhs[i])) return -1;
+                if (lt(rhs[i], lhs[i])) return 1;
+            }
+            return 0;
+        }
+
+        static constexpr const CharT* find(const CharT* s, size_t count, const CharT& ch) noexcept {
+            for (size_t i = 0; i < count; ++i) {
+                if (eq(s[i], ch))
+                    return s + i;
+            }
+            return nullptr;
+        }
+    };
+
+    template<typename CharT, typename Traits = std::char_traits<CharT>>
+    class basic_string_view {
+    private:
+        static_assert(std::is_same_v<typename Traits::char_type, CharT>,
+            "basic_string_view<CharT, Traits> requires Traits::char_type to be CharT");
+    public:
+        using traits_type = Traits;
+        using value_type = CharT;
+        using size_type = size_t;
+        using difference_type = ptrdiff_t;
+        using pointer = CharT*;
+        using const_pointer = const CharT*;
+        using reference = CharT&;
+        using const_reference = const CharT&;
+
+        using const_iterator = string_const_iterator<basic_string_view>;
+        using iterator = const_iterator;
+
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        using reverse_iterator = const_reverse_iterator;
+    public:
+        static constexpr size_type npos = static_cast<size_type>(-1);
+
+        constexpr basic_string_view() noexcept = default;
+
+        constexpr basic_string_view(const CharT* s, size_type count) noexcept
+            : _data(s), _size(count) {}
+
+        constexpr basic_string_view(const CharT* s) noexcept
+            : _data(s), _size(Traits::length(s)) {}
+
+        basic_string_view(std::nullptr_t) = delete;
+
+        constexpr basic_string_view(const basic_string_view&) noexcept = default;
+
+        constexpr basic_string_view& operator=(const basic_string_view&) noexcept = default;
+
+        constexpr const_reference at(const size_type index) const {
+            if (size() <= index)
+                throw std::out_of_range("at: index is out of range");
+
+            return _data[index];
+        }
+
+        constexpr const_reference operator[](const size_type index) const noexcept {
+            return _data[index];
+        }
+
+        constexpr const_reference front() const noexcept {
+            return _data[0];
+        }
+
+        constexpr const_reference back() const noexcept {
+            return _data[_size - 1];
+        }
+
+        constexpr const_pointer data() const noexcept {
+            return _data;
+        }
+
+        constexpr const_iterator begin() const noexcept {
+            return const_iterator(_data);
+        }
+
+        constexpr const_iterator end() const noexcept {
+            return const_iterator(_data + _size);
+        }
+
+        constexpr const_iterator cbegin() const noexcept {
+            return begin();
+        }
+
+        constexpr const_iterator cend() const noexcept {
+            return end();
+        }
+
+        constexpr const_reverse_iterator rbegin() const noexcept {
+            return const_reverse_iterator(end());
+        }
+
+        constexpr const_reverse_iterator rend() const noexcept {
+            return const_reverse_iterator(begin());
+        }
+
+        constexpr const_reverse_iterator crbegin() const noexcept {
+            return rbegin();
+        }
+
+        constexpr const_reverse_iterator crend() const noexcept {
+            return rend();
+        }
+
+        constexpr bool empty() const noexcept {
+            return _size == 0;
+        }
+
+        constexpr size_type size() const noexcept {
+            return _size;
+        }
+
+        constexpr size_type length() const noexcept {
+            return _size;
+        }
+
+        constexpr size_type max_size() const noexcept {
+            return std::numeric_limits<size_type>::max() / sizeof(CharT);
+        }
+
+        constexpr void remove_prefix(size_type count) noexcept {
+            _data += count;
+            _size -= count;
+        }
+
+        constexpr void remove_suffix(size_type count) noexcept {
+            _size -= count;
+        }
+
+        constexpr void swap(basic_string_view& other) noexcept {
+            const basic_string_view temp = *this;
+            *this = other;
+            other = temp;
+        }
+
+        size_type copy(CharT* dest, size_type count, size_type pos = 0) const {
+            if (pos > size())
+                throw std::out_of_range("copy: pos is out of range");
+
+            size_type real_count = std::min(count, size() - pos);
+            Traits::copy(dest, _data + pos, real_count);
+            return real_count;
+        }
+
+        constexpr basic_string_view substr(size_type pos = 0, size_type count = npos) const {
+            if (pos > size())
+                throw std::out_of_range("substr: pos is out of range");
+
+            return basic_string_view(_data + pos, std::min(count, size() - pos));
+        }
+
+        constexpr int compare(basic_string_view sv) const noexcept {
+            size_type min_len = std::min(size(), sv.size());
+            int result = Traits::compare(_data, sv._data, min_len);
+            if (result != 0) return result;
+            if (size() < sv.size()) return -1;
+            if (size() > sv.size()) return 1;
+            return 0;
+        }
+
+        constexpr int compare(size_type pos1, size_type count1, basic_string_view sv) const {
+            return substr(pos1, count1).compare(sv);
+        }
+
+        constexpr int compare(size_type pos1, size_type count1, basic_string_view sv,
+                              size_type pos2, size_type count2) const {
+            return substr(pos1, count1).compare(sv.substr(pos2, count2));
+        }
+
+        constexpr int compare(const CharT* s) const {
+            return compare(basic_string_view(s));
+        }
+
+        constexpr int compare(size_type pos1, size_type count1, const CharT* s) const {
+            return substr(pos1, count1).compare(basic_string_view(s));
+        }
+
+        constexpr int compare(size_type pos1, size_type count1,
+                              const CharT* s, size_type count2) const {
+            return substr(pos1, count1).compare(basic_string_view(s, count2));
+        }
+
+        constexpr bool starts_with(basic_string_view sv) const noexcept {
+            return size() >= sv.size() && Traits::compare(_data, sv._data, sv.size()) == 0;
+        }
+
+        constexpr bool starts_with(CharT ch) const noexcept {
+            return !empty() && Traits::eq(front(), ch);
+        }
+
+        constexpr bool starts_with(const CharT* s) const {
+            return starts_with(basic_string_view(s));
+        }
+
+        constexpr bool ends_with(basic_string_view sv) const noexcept {
+            return size() >= sv.size()
+                && Traits::compare(_data + size() - sv.size(), sv._data, sv.size()) == 0;
+        }
+
+        constexpr bool ends_with(CharT ch) const noexcept {
+            return !empty() && Traits::eq(back(), ch);
+        }
+
+        constexpr bool ends_with(const CharT* s) const {
+            return ends_with(basic_string_view(s));
+        }
+
+        size_type find(basic_string_view sv, size_type pos = 0) const noexcept {
+            return find(sv._data, pos, sv._size);
+        }
+
+        size_type find(const CharT* s, size_type pos, size_type count) const noexcept {
+            return detail::search<Traits>(_data, _size, pos, s, count);
+        }
+
+        size_type find(const CharT* s, size_type pos = 0) const noexcept {
+            return find(s, pos, Traits::length(s));
+        }
+
+        size_type find(CharT ch, size_type pos = 0) const noexcept {
+            return detail::find_char<Traits>(_data, _size, pos, ch);
+        }
+
+        size_type rfind(basic_string_view sv, size_type pos = npos) const noexcept {
+            return rfind(sv._data, pos, sv._size);
+        }
+
+        size_type rfind(const CharT* s, size_type pos, size_type count) const noexcept {
+            return detail::reverse_search<Traits>(_data, _size, pos, s, count);
+        }
+
+        size_type rfind(const CharT* s, size_type pos = npos) const noexcept {
+            return rfind(s, pos, Traits::length(s));
+        }
+
+        size_type rfind(CharT ch, size_type pos = npos) const noexcept {
+            return detail::rfind_char<Traits>(_data, _size, pos, ch);
+        }
+
+        size_type find_first_of(basic_string_view sv, size_type pos = 0) const noexcept {
+            return find_first_of(sv._data, pos, sv._size);
+        }
+
+        size_type find_first_of(const CharT* s, size_type pos, size_type count) const noexcept {
+            return detail::find_in_set<Traits, true>(_data, _size, pos, s, count);
+        }
+
+        size_type find_first_of(const CharT* s, size_type pos = 0) const noexcept {
+            return find_first_of(s, pos, Traits::length(s));
+        }
+
+        size_type find_first_of(CharT ch, size_type pos = 0) const noexcept {
+            return find(ch, pos);
+        }
+
+        size_type find_first_not_of(basic_string_view sv, size_type pos = 0) const noexcept {
+            return find_first_not_of(sv._data, pos, sv._size);
+        }
+
+        size_type find_first_not_of(const CharT* s, size_type pos, size_type count) const noexcept {
+            return detail::find_in_set<Traits, false>(_data, _size, pos, s, count);
+        }
+
+        size_type find_first_not_of(const CharT* s, size_type pos = 0) const noexcept {
+            return find_first_not_of(s, pos, Traits::length(s));
+        }
+
+        size_type find_first_not_of(CharT ch, size_type pos = 0) const noexcept {
+            return find_first_not_of(&ch, pos, 1);
+        }
+
+        size_type find_last_of(basic_string_view sv, size_type pos = npos) const noexcept {
+            return find_last_of(sv._data, pos, sv._size);
+        }
+
+        size_type find_last_of(const CharT* s, size_type pos, size_type count) const noexcept {
+            return detail::reverse_find_in_set<Traits, true>(_data, _size, pos, s, count);
+        }
+
+        size_type find_last_of(const CharT* s, size_type pos = npos) const noexcept {
+            return find_last_of(s, pos, Traits::length(s));
+        }
+
+        size_type find_last_of(CharT ch, size_type pos = npos) const noexcept {
+            return rfind(ch, pos);
+        }
+
+        size_type find_last_not_of(basic_string_view sv, size_type pos = npos) const noexcept {
+            return find_last_not_of(sv._data, pos, sv._size);
+        }
+
+        size_type find_last_not_of(const CharT* s, size_type pos, size_type count) const noexcept {
+            return detail::reverse_find_in_set<Traits, false>(_data, _size, pos, s, count);
+        }
+
+        size_type find_last_not_of(const CharT* s, size_type pos = npos) const noexcept {
+            return find_last_not_of(s, pos, Traits::length(s));
+        }
+
+        size_type find_last_not_of(CharT ch, size_type pos = npos) const noexcept {
+            return find_last_not_of(&ch, pos, 1);
+        }
+    private:
+        const CharT* _data = nullptr;
+        size_t _size = 0;
+    };
+
+    // The type_identity_t overloads let a string or a C string on either
+    // side compare against a view without an explicit conversion.
+    template<typename CharT, typename Traits>
+    constexpr bool operator==(basic_string_view<CharT, Traits> lhs,
+                              basic_string_view<CharT, Traits> rhs) noexcept {
+        return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
+    }
+
+    template<typename CharT, typename Traits>
+    constexpr bool operator==(basic_string_view<CharT, Traits> lhs,
+                              type_identity_t<basic_string_view<CharT, Traits>> rhs) noexcept {
+        return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
+    }
+
+    template<typename CharT, typename Traits>
+    constexpr bool operator==(type_identity_t<basic_string_view<CharT, Traits>> lhs,
+                              basic_string_view<CharT, Traits> rhs) noexcept {
+        return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
+    }
+
+    template<typename CharT, typename Traits>
+    constexpr bool operator!=(basic_string_view<CharT, Traits> lhs,
+                              basic_string_view<CharT, Traits> rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+    template<typename CharT, typename Traits>
+    constexpr bool operator!=(basic_string_view<CharT, Traits> lhs,
+                              type_identity_t<basic_string_view<CharT, Traits>> rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+    template<typename CharT, typename Traits>
+    constexpr bool operator!=(type_identity_t<basic_string_view<CharT, Traits>> lhs,
+                              basic_string_view<CharT, Traits> rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+    template<typename CharT, typename Traits>
+    constexpr bool operator<(basic_string_view<CharT, Traits> lhs,
+                             basic_string_view<CharT, Traits> rhs) noexcept {
+        return lhs.compare(rhs) < 0;
+    }
+
+    template<typename CharT, typename Traits>
+    constexpr bool operator<(basic_string_view<CharT, Traits> lhs,
+                             type_identity_t<basic_string_view<CharT, Traits>> rhs) noexcept {
+        return lhs.compare(rhs) < 0;
+    }
+
+    template<typename CharT, typename Traits>
+    constexpr bool operator<(type_identity_t<basic_string_view<CharT, Traits>> lhs,
+                             basic_string_view<CharT, Traits> rhs) noexcept {
+        return lhs.compare(rhs) < 0;
+    }
+
+    template<typename CharT, typename Traits>
+    constexpr bool operator>(basic_string_view<CharT, Traits> lhs,
+                             basic_string_view<CharT, Traits> rhs) noexcept {
+        return lhs.compare(rhs) > 0;
+    }
+
+    template<typename CharT, typename Traits>
+    constexpr bool operator>(basic_string_view<CharT, Traits> lhs,
+                             type_identity_t<basic_string_view<CharT, Traits>> rhs) noexcept {
+        return lhs.compare(rhs) > 0;
+    }
+
+    template<typename CharT, typename Traits>
+    constexpr bool operator>(type_identity_t<basic_string_view<CharT, Traits>> lhs,
+                             basic_string_view<CharT, Traits> rhs) noexcept {
+        return lhs.compare(rhs) > 0;
+    }
+
+    template<typename CharT, typename Traits>
+    constexpr bool operator<=(basic_string_view<CharT, Traits> lhs,
+                              basic_string_view<CharT, Traits> rhs) noexcept {
+        return lhs.compare(rhs) <= 0;
+    }
+
+    template<typename CharT, typename Traits>
+    constexpr bool operator<=(basic_string_view<CharT, Traits> lhs,
+                              type_identity_t<basic_string_view<CharT, Traits>> rhs) noexcept {
+        return lhs.compare(rhs) <= 0;
+    }
+
+    template<typename CharT, typename Traits>
+    constexpr bool operator<=(type_identity_t<basic_string_view<CharT, Traits>> lhs,
+                              basic_string_view<CharT, Traits> rhs) noexcept {
+        return lhs.compare(rhs) <= 0;
+    }
+
+    template<typename CharT, typename Traits>
+    constexpr bool operator>=(basic_string_view<CharT, Traits> lhs,
+                              basic_string_view<CharT, Traits> rhs) noexcept {
+        return lhs.compare(rhs) >= 0;
+    }
+
+    template<typename CharT, typename Traits>
+    constexpr bool operator>=(basic_string_view<CharT, Traits> lhs,
+                              type_identity_t<basic_string_view<CharT, Traits>> rhs) noexcept {
+        return lhs.compare(rhs) >= 0;
+    }
+
+    template<typename CharT, typename Traits>
+    constexpr bool operator>=(type_identity_t<basic_string_view<CharT, Traits>> lhs,
+                              basic_string_view<CharT, Traits> rhs) noexcept {
+        return lhs.compare(rhs) >= 0;
+    }
+
+    template<typename CharT, typename Traits>
+    std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os,
+                                                  basic_string_view<CharT, Traits> sv) {
+        return os.write(sv.data(), static_cast<std::streamsize>(sv.size()));
+    }
+
+    using string_view = basic_string_view<char>;
+    using wstring_view = basic_string_view<wchar_t>;
+    using u16string_view = basic_string_view<char16_t>;
+    using u32string_view = basic_string_view<char32_t>;
+
+    using ci_string_view = basic_string_view<char, ci_char_traits<char>>;
+    using ci_wstring_view = basic_string_view<wchar_t, ci_char_traits<wchar_t>>;
+
+    // Transparent: anything convertible to a view (strings, literals) is
+    // hashed and compared without building a key.
+    template<typename CharT>
+    struct hash<basic_string_view<CharT>> {
+        using is_transparent = void;
+
+        size_t operator()(basic_string_view<CharT> sv) const noexcept {
+            return hash_bytes(sv.data(), sv.size() * sizeof(CharT));
+        }
+    };
+
+    template<typename CharT>
+    struct equal_to<basic_string_view<CharT>> {
+        using is_transparent = void;
+
+        constexpr bool operator()(basic_string_view<CharT> lhs, basic_string_view<CharT> rhs) const noexcept {
+            return lhs == rhs;
+        }
+    };
+}
+
+namespace std {
+    template<typename CharT>
+    struct hash<lzt::basic_string_view<CharT>> {
+        size_t operator()(lzt::basic_string_view<CharT> sv) const noexcept {
+            return lzt::hash<lzt::basic_string_view<CharT>>()(sv);
+        }
+    };
+}
+
+#endif // LZT_STRING_VIEW_H
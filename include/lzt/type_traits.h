@@ -0,0 +1,59 @@
+#ifndef LZT_TYPE_TRAITS_H
+#define LZT_TYPE_TRAITS_H
+
+#include <memory>
+#include <utility>
+#include <type_traits>
+
+namespace lzt {
+	template<typename T>
+	struct type_identity {
+		using type = T;
+	};
+
+	template<typename T>
+	using type_identity_t = typename type_identity<T>::type;
+
+	template<typename T>
+	struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+	template<typename T>
+	inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+	template<typename T>
+	struct is_trivially_relocatable<std::allocator<T>> : std::true_type {};
+
+	template<typename T>
+	struct is_trivially_relocatable<std::default_delete<T>> : std::true_type {};
+
+	template<typename First, typename Second>
+	struct is_trivially_relocatable<std::pair<First, Second>> : std::bool_constant<
+		is_trivially_relocatable_v<std::remove_cv_t<First>> && is_trivially_relocatable_v<std::remove_cv_t<Second>>> {};
+
+	template<typename Allocator, typename = void>
+	struct allocator_has_construct : std::false_type {};
+
+	template<typename Allocator>
+	struct allocator_has_construct<Allocator, std::void_t<decltype(std::declval<Allocator&>().construct(
+		std::declval<typename Allocator::value_type*>(),
+		std::declval<typename Allocator::value_type&&>()))>> : std::true_type {};
+
+	template<typename Allocator, typename = void>
+	struct allocator_has_destroy : std::false_type {};
+
+	template<typename Allocator>
+	struct allocator_has_destroy<Allocator, std::void_t<decltype(std::declval<Allocator&>().destroy(
+		std::declval<typename Allocator::value_type*>()))>> : std::true_type {};
+
+	template<typename Allocator>
+	struct uses_default_construct : std::bool_constant<
+		!allocator_has_construct<Allocator>::value && !allocator_has_destroy<Allocator>::value> {};
+
+	template<typename T>
+	struct uses_default_construct<std::allocator<T>> : std::true_type {};
+
+	template<typename Allocator>
+	inline constexpr bool uses_default_construct_v = uses_default_construct<Allocator>::value;
+}
+
+#endif // LZT_TYPE_TRAITS_H
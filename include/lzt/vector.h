@@ -2,8 +2,13 @@
 #ifndef LZT_VECTOR_H
 #define LZT_VECTOR_H
 
+#include <memory>
+#include <stdexcept>
 #include <initializer_list>
 #include <algorithm>
+#include "hash.h"
+#include "type_traits.h"
+#include "detail/vector_base.h"
 
 namespace lzt {
 	template<typename vector>
@@ -182,12 +187,23 @@ namespace lzt {
 		}
 	};
 
-	template <typename T>
-	class vector {
+	template <typename T, typename Allocator = std::allocator<T>>
+	class vector : private detail::vector_base<vector<T, Allocator>, T, Allocator> {
+	private:
+		using myBase = detail::vector_base<vector<T, Allocator>, T, Allocator>;
+		using alloc_traits = std::allocator_traits<Allocator>;
+
+		friend myBase;
+
+		static_assert(std::is_same_v<typename alloc_traits::value_type, T>,
+			"vector<T, Allocator> requires Allocator::value_type to be T");
+		static_assert(std::is_same_v<typename alloc_traits::pointer, T*>,
+			"vector<T, Allocator> requires an allocator with raw pointers");
 	public:
 		using value_type = T;
-		using size_type = size_t;
-		using difference_type = ptrdiff_t;
+		using allocator_type = Allocator;
+		using size_type = typename alloc_traits::size_type;
+		using difference_type = typename alloc_traits::difference_type;
 		using pointer = T*;
 		using const_pointer = const T*;
 		using reference = T&;
@@ -199,40 +215,85 @@ namespace lzt {
 		using reverse_iterator = std::reverse_iterator<iterator>;
 		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 	public:
-		vector() : _data(nullptr), _size(0), _capacity(0) {}
+		vector() noexcept(std::is_nothrow_default_constructible_v<Allocator>) {}
 
-		vector(std::initializer_list<T> init) : _size(init.size()), _capacity(init.size()) {
-			_data = (T*)::operator new(_capacity * sizeof(T));
-			size_type i = 0;
-			for (const auto& el : init) {
-				new (&_data[i++]) T(std::move(el));
-			}
+		explicit vector(const Allocator& alloc) noexcept
+			: myBase(std::in_place, alloc) {}
+
+		vector(std::initializer_list<T> init, const Allocator& alloc = Allocator())
+			: myBase(std::in_place, alloc) {
+
+			_construct_elements(init.begin(), init.size());
 		}
 
 		vector(const vector& other)
-			: _data((T*)::operator new(other._capacity * sizeof(T))), _size(other._size), _capacity(other._capacity) {
+			: vector(other, alloc_traits::select_on_container_copy_construction(other._alloc())) {}
+
+		vector(const vector& other, const Allocator& alloc)
+			: myBase(std::in_place, alloc) {
+
+			_construct_elements(other._data, other._size);
+		}
+
+		vector(vector&& other) noexcept
+			: myBase(std::in_place, std::move(other._alloc())) {
+
+			_steal(other);
+		}
 
-			for (size_t i = 0; i < _size; i++) {
-				new (&_data[i]) T(other._data[i]);
+		vector(vector&& other, const Allocator& alloc)
+			: myBase(std::in_place, alloc) {
+
+			if (alloc_traits::is_always_equal::value || _alloc() == other._alloc()) {
+				_steal(other);
+				return;
 			}
+
+			_construct_elements(std::make_move_iterator(other._data), other._size);
 		}
 
-		vector& operator=(vector other) {
-			swap(other);
+		vector& operator=(const vector& other) {
+			if (this == &other)
+				return *this;
+
+			if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+				if (!alloc_traits::is_always_equal::value && _alloc() != other._alloc())
+					_tidy();
+				_alloc() = other._alloc();
+			}
+
+			_assign_elements(other._data, other._size);
 			return *this;
 		}
 
-		vector(vector&& other) noexcept
-			: _data(other._data), _size(other._size), _capacity(other._capacity) {
+		vector& operator=(vector&& other) noexcept(
+			alloc_traits::propagate_on_container_move_assignment::value
+			|| alloc_traits::is_always_equal::value) {
 
-			other._data = nullptr;
-			other._size = 0;
-			other._capacity = 0;
+			if (this == &other)
+				return *this;
+
+			if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+				_tidy();
+				_alloc() = std::move(other._alloc());
+				_steal(other);
+			} else {
+				if (alloc_traits::is_always_equal::value || _alloc() == other._alloc()) {
+					_tidy();
+					_steal(other);
+				} else {
+					_assign_elements(std::make_move_iterator(other._data), other._size);
+				}
+			}
+			return *this;
 		}
 
 		~vector() {
-			clear();
-			::operator delete(_data);
+			_tidy();
+		}
+
+		constexpr allocator_type get_allocator() const noexcept {
+			return _alloc();
 		}
 
 		constexpr reference at(const size_type index) {
@@ -338,10 +399,13 @@ namespace lzt {
 		}
 
 		constexpr size_type max_size() const noexcept {
-			return std::numeric_limits<size_type>::max() / sizeof(T);
+			return _max_size();
 		}
 
-		constexpr void reserve(size_t newCapacity) {
+		constexpr void reserve(size_type newCapacity) {
+			if (newCapacity > max_size())
+				throw std::length_error("vector reserve maximum size exceeded");
+
 			if (_capacity < newCapacity)
 				_reallocation(newCapacity);
 		}
@@ -350,15 +414,13 @@ namespace lzt {
 			return _capacity;
 		}
 
-		constexpr void shrink_to_fit() noexcept {
+		constexpr void shrink_to_fit() {
 			if (_size < _capacity)
 				_reallocation(_size);
 		};
 
 		constexpr void clear() noexcept {
-			for (size_t i = 0; i < _size; i++)
-				_data[i].~T();
-			_size = 0;
+			_clear();
 		}
 
 		iterator insert(const_iterator pos, const T& value) {
@@ -373,99 +435,57 @@ namespace lzt {
 			if (pos < cbegin() || pos > cend())
 				throw std::out_of_range("vector insert position out of range");
 
-			const difference_type offset = pos - cbegin();
-			if (count == 0) return begin() + offset;
-
-			if (count > max_size() - _size)
-				throw std::length_error("vector insert maximum size exceeded");
-
-			if (_size + count > _capacity)
-				_reallocation(std::max(_size + count, _capacity * 2));
-
-			iterator it = begin() + offset;
-			const size_type elems_after = end() - it;
-
-			for (size_type i = 0; i < elems_after; i++) {
-				new (&_data[_size + count - 1 - i]) T(std::move(_data[_size - 1 - i]));
-				_data[_size - 1 - i].~T();
-			}
-
-			for (size_type i = 0; i < count; ++i) {
-				new (&_data[offset + i]) T(value);
+			const size_type offset = pos - cbegin();
+			if (_is_inside(std::addressof(value))) {
+				const T copy(value);
+				return insert(pos, count, copy);
 			}
 
-			_size += count;
-			return it;
+			_insert_forward(offset, _repeat_iterator(value), count);
+			return begin() + offset;
 		}
 
-		template<typename InputIt>
+		template<typename InputIt, std::enable_if_t<std::is_convertible_v<
+			typename std::iterator_traits<InputIt>::iterator_category, std::input_iterator_tag>, int> = 0>
 		iterator insert(const_iterator pos, InputIt first, InputIt last) {
-			if (pos < begin() || pos > end())
+			if (pos < cbegin() || pos > cend())
 				throw std::out_of_range("vector insert position is out of range");
 
-			difference_type offset = pos - cbegin();
-			size_type count = std::distance(first, last);
-			if (count == 0) return begin() + offset;
-
-			if (count > max_size() - _size)
-				throw std::length_error("vector insert maximum size exceeded");
-
-			if (_size + count > _capacity) {
-				_reallocation(std::max(_size + count, _capacity * 2));
+			const size_type offset = pos - cbegin();
+			if constexpr (std::is_convertible_v<typename std::iterator_traits<InputIt>::iterator_category,
+				std::forward_iterator_tag>) {
+				_insert_forward(offset, first, static_cast<size_type>(std::distance(first, last)));
+			} else {
+				const size_type oldSize = _size;
+				for (; first != last; ++first)
+					emplace_back(*first);
+				std::rotate(_data + offset, _data + oldSize, _data + _size);
 			}
-
-			iterator it = begin() + offset;
-			const size_type elems_after = end() - it;
-
-			for (size_type i = 0; i < elems_after; i++) {
-				new (&_data[_size + count - 1 - i]) T(std::move(_data[_size - 1 - i]));
-				_data[_size - 1 - i].~T();
-			}
-
-			try {
-				for (size_type i = 0; i < count; ++i, ++first) {
-					new (&_data[offset + i]) T(*first);
-				}
-			} catch (...) {
-				for (size_type i = 0; i < count; ++i) {
-					if (offset + i < _size + count) {
-						_data[offset + i].~T();
-					}
-				}
-				throw;
-			}
-
-			_size += count;
-			return it;
+			return begin() + offset;
 		}
 
 		iterator insert(const_iterator pos, std::initializer_list<T> ilist) {
 			return insert(pos, ilist.begin(), ilist.end());
 		}
 
+		template<typename Range>
+		iterator insert_range(const_iterator pos, Range&& range) {
+			return insert(pos, std::begin(range), std::end(range));
+		}
+
+		template<typename Range>
+		void append_range(Range&& range) {
+			insert(cend(), std::begin(range), std::end(range));
+		}
+
 		template<typename... Args>
-		constexpr iterator emplace(const_iterator pos, Args&&... args) {
+		iterator emplace(const_iterator pos, Args&&... args) {
 			if (pos < cbegin() || pos > cend())
 				throw std::out_of_range("vector emplace position out of range");
 
-			const difference_type offset = pos - cbegin();
-
-			if (_size == _capacity)
-				_reallocation(_capacity ? _capacity * 2 : 1);
-
-			iterator it = begin() + offset;
-			if (it != end()) {
-				new (&_data[_size]) T(std::move(_data[_size - 1]));
-
-				std::move_backward(it, end() - 1, end());
-
-				it->~T();
-			}
-
-			new (&*it) T(std::forward<Args>(args)...);
-
-			_size++;
-			return it;
+			const size_type offset = pos - cbegin();
+			_emplace_at(offset, std::forward<Args>(args)...);
+			return begin() + offset;
 		}
 
 		iterator erase(const_iterator pos) {
@@ -477,101 +497,153 @@ namespace lzt {
 				throw std::out_of_range("vector::erase - invalid range");
 			}
 
-			if (first == last) return begin() + (first - cbegin());
-
-			const difference_type offset = first - cbegin();
-			const size_type count = last - first;
-			iterator it = begin() + offset;
-
-			for (size_type i = 0; i < count; ++i) {
-				_data[offset + i].~T();
-			}
-
-			for (size_type i = 0; i < _size - offset - count; ++i) {
-				_data[offset + i] = std::move(_data[offset + count + i]);
-			}
-
-			for (size_type i = _size - count; i < _size; ++i) {
-				_data[i].~T();
-			}
-
-			_size -= count;
-			return it;
+			const size_type offset = first - cbegin();
+			_erase_range(offset, last - first);
+			return begin() + offset;
 		}
 
 		constexpr void push_back(const T& value) {
-			if (_size >= _capacity)
-				_reallocation(_capacity ? _capacity * 2 : 1);
-
-			new (&_data[_size]) T(value);
-			++_size;
+			emplace_back(value);
 		}
 
 		constexpr void push_back(T&& value) {
-			if (_size >= _capacity)
-				_reallocation(_capacity ? _capacity * 2 : 1);
-
-			new (&_data[_size]) T(std::move(value));
-			++_size;
+			emplace_back(std::move(value));
 		}
 
 		template<typename... Args>
 		constexpr reference emplace_back(Args&&... args) {
 			if (_size >= _capacity)
-				_reallocation(_capacity ? _capacity * 2 : 1);
+				return *_reallocation_insert(_size, std::forward<Args>(args)...);
 
-			new (&_data[_size]) T(std::forward<Args>(args)...);
+			_construct(_data + _size, std::forward<Args>(args)...);
 			return _data[_size++];
 		}
 
 		constexpr void pop_back() noexcept {
 			--_size;
-			_data[_size].~T();
+			_destroy(_data + _size);
 		}
 
 		constexpr void resize(size_type newSize) {
 			resize(newSize, T());
 		}
 
-		constexpr void resize(size_type newSize, const T& value) {
-			if (_size < newSize) {
-				reserve(newSize);
+		void resize(size_type newSize, const T& value) {
+			_resize(newSize, value);
+		}
 
-				for (size_t i = _size; i < newSize; i++)
-					new (&_data[i]) T(value);
-			} else if (newSize < _size) {
-				for (size_t i = newSize; i < _size; i++)
-					_data[i].~T();
-			}
-			_size = newSize;
+		// Like resize, but new elements are default-initialized, so trivial
+		// types are left as they are for the caller to overwrite.
+		void resize_for_overwrite(size_type newSize) {
+			_resize_for_overwrite(newSize);
 		}
 
 		constexpr void swap(vector& other) noexcept {
+			if constexpr (alloc_traits::propagate_on_container_swap::value) {
+				using std::swap;
+				swap(_alloc(), other._alloc());
+			}
 			std::swap(_data, other._data);
 			std::swap(_size, other._size);
 			std::swap(_capacity, other._capacity);
 		}
-	private:
-		constexpr void _reallocation(const size_t newCapacity) noexcept {
-			T* newData = (T*)::operator new(newCapacity * sizeof(T));
 
-			if (newCapacity < _size)
-				_size = newCapacity;
+		friend constexpr void swap(vector& lhs, vector& rhs) noexcept {
+			lhs.swap(rhs);
+		}
+
+		friend bool operator==(const vector& lhs, const vector& rhs) {
+			return std::equal(lhs.data(), lhs.data() + lhs.size(), rhs.data(), rhs.data() + rhs.size());
+		}
 
-			for (size_t i = 0; i < _size; i++)
-				new (&newData[i]) T(std::move(_data[i]));
+		friend bool operator!=(const vector& lhs, const vector& rhs) {
+			return !(lhs == rhs);
+		}
 
-			for (size_t i = 0; i < _size; i++)
-				_data[i].~T();
+		friend bool operator<(const vector& lhs, const vector& rhs) {
+			return std::lexicographical_compare(lhs.data(), lhs.data() + lhs.size(), rhs.data(), rhs.data() + rhs.size());
+		}
 
-			::operator delete(_data);
+		friend bool operator>(const vector& lhs, const vector& rhs) {
+			return rhs < lhs;
+		}
+
+		friend bool operator<=(const vector& lhs, const vector& rhs) {
+			return !(rhs < lhs);
+		}
+
+		friend bool operator>=(const vector& lhs, const vector& rhs) {
+			return !(lhs < rhs);
+		}
+	private:
+		static constexpr const char* _max_size_message = "vector maximum size exceeded";
+
+		using typename myBase::_repeat_iterator;
+		using myBase::_data;
+		using myBase::_size;
+		using myBase::_capacity;
+		using myBase::_alloc;
+		using myBase::_max_size;
+		using myBase::_construct;
+		using myBase::_destroy;
+		using myBase::_is_inside;
+		using myBase::_clear;
+		using myBase::_tidy;
+		using myBase::_construct_elements;
+		using myBase::_assign_elements;
+		using myBase::_reallocation;
+		using myBase::_reallocation_insert;
+		using myBase::_insert_forward;
+		using myBase::_emplace_at;
+		using myBase::_erase_range;
+		using myBase::_resize;
+		using myBase::_resize_for_overwrite;
+
+		pointer _allocate(const size_type count) {
+			return count ? alloc_traits::allocate(_alloc(), count) : nullptr;
+		}
+
+		void _deallocate(pointer ptr, const size_type count) noexcept {
+			if (ptr)
+				alloc_traits::deallocate(_alloc(), ptr, count);
+		}
+
+		void _adopt(pointer newData, const size_type newSize, const size_type newCapacity) noexcept {
+			_deallocate(_data, _capacity);
 			_data = newData;
+			_size = newSize;
 			_capacity = newCapacity;
 		}
-	private:
-		pointer _data = nullptr;
-		size_type _size = 0;
-		size_type _capacity = 0;
+
+		void _release() noexcept {
+			_deallocate(_data, _capacity);
+			_data = nullptr;
+			_capacity = 0;
+		}
+
+		void _steal(vector& other) noexcept {
+			_data = other._data;
+			_size = other._size;
+			_capacity = other._capacity;
+
+			other._data = nullptr;
+			other._size = 0;
+			other._capacity = 0;
+		}
+	};
+
+	template<typename T, typename Allocator>
+	struct is_trivially_relocatable<vector<T, Allocator>>
+		: std::bool_constant<is_trivially_relocatable_v<Allocator>> {};
+}
+
+namespace std {
+	template<typename T, typename Allocator>
+	struct hash<lzt::vector<T, Allocator>> {
+		size_t operator()(const lzt::vector<T, Allocator>& vec) const
+			noexcept(noexcept(lzt::hash_range(vec.data(), vec.size()))) {
+			return lzt::hash_range(vec.data(), vec.size());
+		}
 	};
 }
 